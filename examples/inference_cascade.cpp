@@ -0,0 +1,41 @@
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include "GLiNER/gliner_config.hpp"
+#include "GLiNER/model.hpp"
+#include "GLiNER/cascade.hpp"
+
+int main() {
+    gliner::Config config{12, 512};  // Set your maxWidth and maxLength
+    gliner::Config largeConfig{12, 512, gliner::TOKEN_LEVEL};  // gliner-multitask-large-v0.5 is a token-level model
+    gliner::Model small("./gliner_small-v2.1/onnx/model.onnx", "./gliner_small-v2.1/tokenizer.json", config);
+    gliner::Model large("./gliner-multitask-large-v0.5/onnx/model.onnx", "./gliner-multitask-large-v0.5/tokenizer.json", largeConfig);
+
+    gliner::CascadeConfig cascadeConfig;
+    cascadeConfig.band = 0.15;  // spans scored in [0.35, 0.65) send the text to the large model
+    gliner::Cascade cascade(small, large, cascadeConfig);
+
+    // A sample input
+    std::vector<std::string> texts = {
+        "Kyiv is the capital of Ukraine.",
+        "Ada Lovelace worked with Charles Babbage on the Analytical Engine."
+    };
+    std::vector<std::string> entities = {"person", "location", "invention"};
+
+    auto output = cascade.inference(texts, entities);
+
+    std::cout << "\nTest Cascade Inference:" << std::endl;
+    for (size_t batch = 0; batch < output.size(); ++batch) {
+        std::cout << "Batch " << batch << ":\n";
+        for (const auto& span : output[batch]) {
+            std::cout << "  Span: [" << span.startIdx << ", " << span.endIdx << "], "
+                      << "Class: " << span.classLabel << ", "
+                      << "Text: " << span.text << ", "
+                      << "Prob: " << span.prob << std::endl;
+        }
+    }
+    std::cout << "Escalation rate: " << cascade.stats().escalationRate() << std::endl;
+
+    return 0;
+}
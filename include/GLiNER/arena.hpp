@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace gliner {
+    // Resettable monotonic arena for per-request intermediates. The initial block
+    // grows to the largest request seen so far, up to maxCapacity, so in steady
+    // state a request does not reach the heap at all. A request larger than the
+    // cap overflows to the heap and that memory is released by the next reset,
+    // so one outlier does not pin its peak on the thread. Every thread owns one
+    // arena (see local()).
+    class Arena {
+    private:
+        // Upstream resource that remembers how much the monotonic buffer overflowed.
+        class CountingResource : public std::pmr::memory_resource {
+        public:
+            size_t allocated = 0;
+        protected:
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+        };
+
+        std::unique_ptr<std::byte[]> buffer;
+        size_t capacity;
+        size_t maxCapacity;
+        CountingResource upstream;
+        std::optional<std::pmr::monotonic_buffer_resource> monotonic;
+        int depth = 0;
+
+    public:
+        explicit Arena(size_t initialCapacity = 64 * 1024, size_t maxCapacity = 16 * 1024 * 1024);
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        std::pmr::memory_resource* resource() { return &*monotonic; }
+        // Frees everything allocated since the last reset; no container using the arena may be alive.
+        void reset();
+        size_t blockSize() const { return capacity; }
+        size_t maxBlockSize() const { return maxCapacity; }
+
+        static Arena& local();
+
+        // Resets the arena when the outermost scope on this thread ends. Declare it
+        // before any container that allocates from the arena.
+        class Scope {
+        private:
+            Arena& arena;
+        public:
+            explicit Scope(Arena& arena) : arena(arena) { arena.depth++; }
+            ~Scope() {
+                if (--arena.depth == 0) {
+                    arena.reset();
+                }
+            }
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+        };
+    };
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "dynamic_batcher.hpp"
+
+namespace gliner {
+    struct AutotuneConfig {
+        double targetP99Millis = 100;   // request latency objective, queueing included
+        size_t minBatchSize = 1;
+        size_t maxBatchSize = 64;
+        std::chrono::microseconds maxWait{20000}; // upper bound for the tuned wait
+        size_t window = 32;             // session runs per decision
+        double headroom = 0.8;          // limits only grow while p99 < headroom * target
+        double runShare = 0.5;          // share of the target one run may take
+    };
+
+    struct AutotuneState {
+        uint64_t decisions = 0;
+        double windowP99Millis = 0;  // request p99 of the last full window
+        double runFixedMillis = 0;   // fitted run latency: fixed + perTokenMillis * texts * words
+        double perTokenMillis = 0;
+    };
+
+    // Tunes the batch limits of a DynamicBatcher online (AIMD). Run latency is fitted
+    // to the padded size of each batch with a decayed least-squares line, which sets
+    // the token budget so that one run stays within runShare of the target. After
+    // every window of runs the request p99 is checked: above the target the batch
+    // size and the wait shrink multiplicatively; with headroom and a backlog (full
+    // batches or requests left in the queue) the batch size grows additively and
+    // the wait grows, trading latency for larger batches. Not synchronized.
+    class BatchAutotuner {
+    private:
+        AutotuneConfig config;
+        BatcherConfig limits;
+        AutotuneState tuned;
+        Histogram windowLatency;
+        size_t windowRuns = 0;
+        size_t windowBacklog = 0;
+        // Decayed sums for the latency fit over x = padded words per run
+        double sw = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+
+        void decide();
+    public:
+        BatchAutotuner(const AutotuneConfig& config, const BatcherConfig& initial);
+
+        // Records one session run; returns true when the limits changed.
+        // backlog is the number of texts left in the queue when the batch was taken.
+        bool observe(size_t texts, size_t words, double runMillis, const std::vector<double>& requestMillis, size_t backlog);
+        const AutotuneConfig& settings() const;
+        const BatcherConfig& current() const;
+        const AutotuneState& state() const;
+    };
+}
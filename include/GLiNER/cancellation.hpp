@@ -0,0 +1,69 @@
+#pragma once
+
+#include <onnxruntime_cxx_api.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gliner {
+    using Clock = std::chrono::steady_clock;
+
+    enum class InferenceStatus {
+        OK,
+        CANCELLED,
+        DEADLINE_EXCEEDED
+    };
+
+    // Shared cancellation flag. Copies refer to the same flag; cancel() also
+    // terminates every session run currently registered with the token.
+    class CancellationToken {
+    private:
+        struct State {
+            std::atomic<bool> cancelled{false};
+            std::mutex mutex;
+            std::vector<Ort::RunOptions*> runs;
+        };
+        std::shared_ptr<State> state;
+    public:
+        CancellationToken();
+        void cancel();
+        bool isCancelled() const;
+        void attach(Ort::RunOptions* run_options);
+        void detach(Ort::RunOptions* run_options);
+    };
+
+    // Per-call deadline and cancellation token, checked between pipeline stages.
+    struct RequestControl {
+        Clock::time_point deadline = Clock::time_point::max();
+        CancellationToken cancellation;
+
+        static RequestControl withTimeout(Clock::duration timeout);
+        InferenceStatus check() const;
+    };
+
+    // Background thread that terminates session runs whose deadline has passed.
+    class Watchdog {
+    private:
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::multimap<Clock::time_point, Ort::RunOptions*> runs;
+        bool stopping = false;
+        std::thread thread;
+
+        void loop();
+    public:
+        Watchdog();
+        ~Watchdog();
+        Watchdog(const Watchdog&) = delete;
+        Watchdog& operator=(const Watchdog&) = delete;
+
+        void watch(Clock::time_point deadline, Ort::RunOptions* run_options);
+        void unwatch(Ort::RunOptions* run_options);
+    };
+}
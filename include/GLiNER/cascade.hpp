@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gliner_structs.hpp"
+#include "model.hpp"
+
+namespace gliner {
+    struct CascadeConfig {
+        float band = 0.15;         // spans scored within threshold +- band are uncertain
+        bool escalateEmpty = true; // also escalate texts without any span above the threshold
+    };
+
+    struct CascadeStats {
+        uint64_t texts;
+        uint64_t escalated;
+
+        double escalationRate() const {
+            return texts == 0 ? 0.0 : double(escalated) / double(texts);
+        }
+    };
+
+    // Two-stage inference: a small model tags every text, and only the texts it is
+    // unsure about are re-tagged by a large model, whose spans replace the small
+    // model's for those texts. Both models are run with the same labels.
+    class Cascade {
+    private:
+        Model& small;
+        Model& large;
+        CascadeConfig config;
+        std::atomic<uint64_t> texts{0};
+        std::atomic<uint64_t> escalated{0};
+    public:
+        Cascade(Model& small, Model& large, const CascadeConfig& config = CascadeConfig());
+        Cascade(const Cascade&) = delete;
+        Cascade& operator=(const Cascade&) = delete;
+
+        // `escalations`, when given, receives the indices of the texts sent to the large model.
+        std::vector<std::vector<Span>> inference(
+            const std::vector<std::string>& texts, const std::vector<std::string>& entities,
+            bool flatNer = true, float threshold = 0.5, bool multiLabel = false,
+            std::vector<size_t>* escalations = nullptr
+        );
+        CascadeStats stats() const;
+
+        // Indices of the texts to escalate. `results` are the small model's spans at the
+        // threshold and `relaxed` those of the same retained logits at threshold - band.
+        static std::vector<size_t> uncertainTexts(
+            const std::vector<std::vector<Span>>& results, const std::vector<std::vector<Span>>& relaxed,
+            float threshold, const CascadeConfig& config
+        );
+    };
+}
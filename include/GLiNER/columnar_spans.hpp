@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "gliner_structs.hpp"
+
+namespace gliner {
+    // Spans of a whole batch as contiguous columns (struct of arrays). Every
+    // column has one entry per span; spans are grouped by row and sorted by
+    // position inside a row. Offsets are byte offsets into the row's text.
+    struct ColumnarSpans {
+        std::vector<std::string> labels;  // label dictionary, indexed by labelId
+        std::vector<uint64_t> rowOffsets; // spans of row r are [rowOffsets[r], rowOffsets[r + 1])
+        std::vector<uint32_t> row;
+        std::vector<int32_t> start;
+        std::vector<int32_t> end;
+        std::vector<uint32_t> labelId;
+        std::vector<float> prob;
+
+        size_t size() const;
+        size_t rows() const;
+        void clear();
+        // Materializes the usual per-row spans; texts are the batch inputs, one per row.
+        // Throws std::invalid_argument when they do not match the rows or their spans.
+        std::vector<std::vector<Span>> toSpans(const std::vector<std::string>& texts) const;
+
+        // Binary dump in native byte order: a header, the label dictionary, then
+        // every column as one raw array, so writing is a memcpy per column.
+        void write(std::ostream& out) const;
+        void save(const std::string& path) const;
+        // Throws std::runtime_error on a truncated or inconsistent file.
+        static ColumnarSpans load(const std::string& path);
+    };
+}
@@ -1,21 +1,113 @@
 #pragma once
 
+#include <cmath>
 #include <vector>
 #include <string>
 
 #include "gliner_config.hpp"
 #include "gliner_structs.hpp"
+#include "inference_result.hpp"
+#include "columnar_spans.hpp"
+#include "arena.hpp"
 
 namespace gliner {
+    // Decoded span before selection; the text and label are only materialized for kept spans.
+    struct SpanCandidate {
+        int startIdx;
+        int endIdx;
+        int entity;
+        float prob;
+    };
+
+    using CandidateRows = std::pmr::vector<std::pmr::vector<SpanCandidate>>;
+
     class Decoder {
     protected:
+        static float sigmoid(float x) {
+            return 1.0 / (1.0 + std::exp(-x));
+        }
         virtual std::vector<Span> greedySearch(const std::vector<Span>&  spans, bool flatNer = true, bool multiLabel = false);
         virtual std::vector<std::vector<Span>> batchGreedySearch(
             const std::vector<std::vector<Span>>&  spans_batch, bool flatNer = true, bool multiLabel = false
         );
-        static bool isNested(const Span& s1, const Span& s2);
-        static bool hasOverlapping(const Span& s1, const Span& s2, bool multiLabel = false);
-        static bool hasOverlappingNested(const Span& s1, const Span& s2, bool multiLabel = false);
+
+        template <typename S>
+        static bool isNested(const S& s1, const S& s2) {
+            return (s1.startIdx <= s2.startIdx && s2.endIdx <= s1.endIdx) || (s2.startIdx <= s1.startIdx && s1.endIdx <= s2.endIdx);
+        }
+
+        // Check for any overlap between two spans
+        template <typename S>
+        static bool hasOverlapping(const S& s1, const S& s2, bool multiLabel = false) {
+            if (s1.startIdx == s2.startIdx && s1.endIdx == s2.endIdx) {
+                return !multiLabel;
+            }
+            if (s1.startIdx > s2.endIdx || s2.startIdx > s1.endIdx) {
+                return false;
+            }
+            return true;
+        }
+
+        // Check if spans overlap but are not nested inside each other
+        template <typename S>
+        static bool hasOverlappingNested(const S& s1, const S& s2, bool multiLabel = false) {
+            return hasOverlapping(s1, s2, multiLabel) || isNested(s1, s2);
+        }
+
+        // Greedy selection over spans sorted by start/end position; appends the indices of kept spans.
+        template <typename S, typename Indices>
+        static void greedySelect(const S* spans, size_t size, bool flatNer, bool multiLabel, Indices& selected) {
+            if (size == 0) {
+                return;
+            }
+            size_t prev = 0, next = 1;
+            for (; next < size; next++) {
+                bool overlap = flatNer
+                    ? hasOverlapping(spans[prev], spans[next], multiLabel)
+                    : hasOverlappingNested(spans[prev], spans[next], multiLabel);
+                if (!overlap) {
+                    selected.push_back(prev);
+                    prev = next;
+                } else if (spans[prev].prob < spans[next].prob) { // get span with higher score on overlap
+                    prev = next;
+                }
+            }
+            selected.push_back(prev);
+        }
+
+        std::vector<std::vector<Span>> selectSpans(
+            const CandidateRows& candidates,
+            const std::vector<std::string>& texts,
+            const std::vector<std::string>& entities,
+            bool flatNer,
+            bool multiLabel
+        );
+        // Same as above with labelsOf(row) giving the label list of each row.
+        template <typename LabelsOf>
+        std::vector<std::vector<Span>> selectRows(
+            const CandidateRows& candidates,
+            const std::vector<std::string>& texts,
+            LabelsOf labelsOf,
+            bool flatNer,
+            bool multiLabel
+        );
+        // Same selection as selectSpans, written to columns without building strings.
+        static void selectColumns(
+            const CandidateRows& candidates,
+            bool flatNer,
+            bool multiLabel,
+            ColumnarSpans& out
+        );
+        // Appends every span scoring at least threshold to its row, sorted by start/end position.
+        virtual void collectCandidates(
+            const std::vector<std::vector<Token>>& batchTokens,
+            int64_t numWords,
+            int64_t width,
+            int numEntities,
+            const std::vector<float>& modelOutput,
+            float threshold,
+            CandidateRows& spans
+        ) = 0;
     public:
         virtual ~Decoder() {};
         virtual std::vector<std::vector<Span>> decode(
@@ -26,14 +118,150 @@ namespace gliner {
             bool flatNer = false,
             float threshold = 0.5,
             bool multiLabel = false
+        );
+        // Per-row label lists: the entity dimension is padded to the longest list and
+        // label slots past the end of a row's list are masked out.
+        std::vector<std::vector<Span>> decode(
+            const Batch* batch,
+            const std::vector<std::string>& texts,
+            const std::vector<std::vector<std::string>>& entities,
+            const std::vector<float>& modelOutput,
+            bool flatNer = false,
+            float threshold = 0.5,
+            bool multiLabel = false
+        );
+        // Merges `extra` candidates, one row per text (e.g. Gazetteer matches), with the
+        // model's before greedy selection. The logits cover the first numModelEntities
+        // of `entities`; batch may be null when the model was not run.
+        std::vector<std::vector<Span>> decodeMerged(
+            const Batch* batch,
+            const std::vector<std::string>& texts,
+            const std::vector<std::string>& entities,
+            size_t numModelEntities,
+            const std::vector<float>& modelOutput,
+            const std::vector<std::vector<SpanCandidate>>& extra,
+            bool flatNer = false,
+            float threshold = 0.5,
+            bool multiLabel = false
+        );
+        // Decodes logits retained by Model::forward with any decoding parameters.
+        std::vector<std::vector<Span>> decode(
+            const InferenceResult& result,
+            bool flatNer = false,
+            float threshold = 0.5,
+            bool multiLabel = false
+        );
+        virtual std::vector<std::vector<Span>> decodeOutput(
+            const std::vector<std::vector<Token>>& batchTokens,
+            int64_t numWords,
+            int64_t width,
+            const std::vector<std::string>& texts,
+            const std::vector<std::string>& entities,
+            const std::vector<float>& modelOutput,
+            bool flatNer = false,
+            float threshold = 0.5,
+            bool multiLabel = false
         ) = 0;
+        // Columnar decoding: replaces the content of `out` with the spans of the whole batch.
+        void decodeColumns(
+            const std::vector<std::vector<Token>>& batchTokens,
+            int64_t numWords,
+            int64_t width,
+            const std::vector<std::string>& entities,
+            const std::vector<float>& modelOutput,
+            ColumnarSpans& out,
+            bool flatNer = false,
+            float threshold = 0.5,
+            bool multiLabel = false
+        );
+        void decodeColumns(
+            const InferenceResult& result,
+            ColumnarSpans& out,
+            bool flatNer = false,
+            float threshold = 0.5,
+            bool multiLabel = false
+        );
     };
 
     class SpanDecoder : public Decoder {
+    protected:
+        virtual void collectCandidates(
+            const std::vector<std::vector<Token>>& batchTokens,
+            int64_t numWords,
+            int64_t width,
+            int numEntities,
+            const std::vector<float>& modelOutput,
+            float threshold,
+            CandidateRows& spans
+        );
     public:
         virtual ~SpanDecoder() {};
-        virtual std::vector<std::vector<Span>> decode(
-            const Batch* batch,
+        // Width > 0 fixes the span width at compile time so the index math below is
+        // constant-folded; Width == 0 uses the runtime width.
+        template <int64_t Width>
+        static void collectSpans(
+            const std::vector<std::vector<Token>>& tokens,
+            int64_t numWords,
+            int64_t width,
+            int numEntities,
+            const std::vector<float>& modelOutput,
+            float threshold,
+            CandidateRows& spans
+        ) {
+            const int64_t w = Width > 0 ? Width : width;
+            int batchSize = tokens.size();
+            int inputLength = numWords;
+
+            int startTokenPadding = w * numEntities;
+            int batchPadding = inputLength * startTokenPadding;
+            int endTokenPadding = numEntities;
+
+            // Process the model output
+            for (size_t id = 0; id < modelOutput.size(); ++id) {
+                float value = modelOutput[id];
+                int batch_id = id / batchPadding;
+                size_t startToken = (id / startTokenPadding) % inputLength;
+                size_t endToken = startToken + ((id / endTokenPadding) % w);
+                int entity = id % numEntities; // always one of entities
+                float prob = sigmoid(value);
+
+                if (prob >= threshold &&
+                    batch_id < batchSize &&
+                    startToken < tokens[batch_id].size() &&
+                    endToken < tokens[batch_id].size()) {
+
+                    spans[batch_id].push_back({
+                        int(tokens[batch_id][startToken].start),
+                        int(tokens[batch_id][endToken].end),
+                        entity,
+                        prob
+                    });
+                }
+            }
+        }
+
+        template <int64_t Width>
+        std::vector<std::vector<Span>> decodeSpans(
+            const std::vector<std::vector<Token>>& tokens,
+            int64_t numWords,
+            int64_t width,
+            const std::vector<std::string>& texts,
+            const std::vector<std::string>& entities,
+            const std::vector<float>& modelOutput,
+            bool flatNer = false,
+            float threshold = 0.5,
+            bool multiLabel = false
+        ) {
+            Arena& arena = Arena::local();
+            Arena::Scope scope(arena);
+            CandidateRows spans(tokens.size(), arena.resource());
+            collectSpans<Width>(tokens, numWords, width, entities.size(), modelOutput, threshold, spans);
+            return selectSpans(spans, texts, entities, flatNer, multiLabel);
+        }
+        virtual std::vector<std::vector<Span>> decodeOutput(
+            const std::vector<std::vector<Token>>& batchTokens,
+            int64_t numWords,
+            int64_t width,
             const std::vector<std::string>& texts,
             const std::vector<std::string>& entities,
             const std::vector<float>& modelOutput,
@@ -44,10 +272,22 @@ namespace gliner {
     };
 
     class TokenDecoder : public Decoder {
+    protected:
+        virtual void collectCandidates(
+            const std::vector<std::vector<Token>>& batchTokens,
+            int64_t numWords,
+            int64_t width,
+            int numEntities,
+            const std::vector<float>& modelOutput,
+            float threshold,
+            CandidateRows& spans
+        );
     public:
         virtual ~TokenDecoder() {};
-        virtual std::vector<std::vector<Span>> decode(
-            const Batch* batch,
+        virtual std::vector<std::vector<Span>> decodeOutput(
+            const std::vector<std::vector<Token>>& batchTokens,
+            int64_t numWords,
+            int64_t width,
             const std::vector<std::string>& texts,
             const std::vector<std::string>& entities,
             const std::vector<float>& modelOutput,
@@ -56,4 +296,4 @@ namespace gliner {
             bool multiLabel = false
         );
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gliner_structs.hpp"
+#include "tokenizer_utils.hpp"
+#include "result_cache.hpp"
+#include "model.hpp"
+
+namespace gliner {
+    struct ChunkConfig {
+        size_t minWords = 64;      // a window ends at the first natural boundary after minWords
+        size_t maxWords = 192;     // and at maxWords at the latest
+        size_t overlapWords = 32;  // context words added on each side of a window
+        size_t batchSize = 8;      // windows per inference call
+    };
+
+    // Byte ranges of one window: the model sees [contextStart, contextEnd) and
+    // the window owns the spans that start inside [coreStart, coreEnd).
+    struct DocumentWindow {
+        size_t coreStart;
+        size_t coreEnd;
+        size_t contextStart;
+        size_t contextEnd;
+    };
+
+    // Splits long texts into overlapping windows. Boundaries are chosen from local
+    // content (sentence ends, line breaks and a rolling word hash) rather than fixed
+    // word counts, so an edit moves only the boundaries near it.
+    class Chunker {
+    private:
+        ChunkConfig config;
+        WhitespaceTokenSplitter splitter;
+    public:
+        explicit Chunker(const ChunkConfig& config = ChunkConfig());
+        std::vector<DocumentWindow> split(const std::string& text);
+    };
+
+    // Chunked inference over one document that is re-tagged after every edit.
+    // Window results are kept by a hash of the window content, so an update runs
+    // the model only on windows whose words changed and on their neighbours,
+    // whose context changed; the spans of all other windows are reused with
+    // their offsets shifted to the new window position.
+    class DocumentSession {
+    private:
+        Model& model;
+        std::vector<std::string> entities;
+        bool flatNer;
+        float threshold;
+        bool multiLabel;
+        Chunker chunker;
+        size_t batchSize;
+        CacheKey params;
+        std::unordered_map<CacheKey, std::vector<Span>, CacheKeyHash> windows; // spans relative to contextStart
+        std::vector<Span> current;
+        size_t numWindows = 0;
+        size_t numRerun = 0;
+    public:
+        DocumentSession(
+            Model& model, std::vector<std::string> entities, const ChunkConfig& config = ChunkConfig(),
+            bool flatNer = true, float threshold = 0.5, bool multiLabel = false
+        );
+
+        // Tags the new document version and returns its spans, sorted by position.
+        const std::vector<Span>& update(const std::string& text);
+        const std::vector<Span>& spans() const;
+        size_t windowCount() const;
+        size_t rerunCount() const; // windows sent to the model by the last update
+    };
+}
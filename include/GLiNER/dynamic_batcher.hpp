@@ -0,0 +1,142 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cancellation.hpp"
+#include "gliner_structs.hpp"
+#include "model.hpp"
+
+namespace gliner {
+    // Fixed-bucket histogram; counts()[i] holds values <= bounds()[i] and the last
+    // count holds everything above the last bound. Not synchronized.
+    class Histogram {
+    private:
+        std::vector<double> upperBounds;
+        std::vector<uint64_t> bucketCounts;
+        uint64_t total = 0;
+        double totalSum = 0;
+    public:
+        explicit Histogram(std::vector<double> bounds = exponential(1, 2, 16));
+
+        void record(double value);
+        void clear();
+        uint64_t count() const;
+        double sum() const;
+        // Upper bound of the bucket holding the q-quantile (the last bound when it is above all of them).
+        double quantile(double q) const;
+        const std::vector<double>& bounds() const;
+        const std::vector<uint64_t>& counts() const;
+
+        // n bounds start, start * factor, start * factor^2, ...
+        static std::vector<double> exponential(double start, double factor, size_t n);
+    };
+
+    struct BatcherConfig {
+        size_t maxBatchSize = 16;          // texts per session run
+        size_t maxTokens = 0;              // texts * longest text in words per run, 0 for no limit
+        std::chrono::microseconds maxWait{2000}; // how long a partial batch waits for more requests
+        size_t maxQueueTexts = 1024;       // submissions beyond this are rejected
+    };
+
+    struct BatcherMetrics {
+        size_t queueDepth = 0;    // texts waiting
+        size_t queueRequests = 0; // requests waiting
+        uint64_t requests = 0;
+        uint64_t rejected = 0;
+        uint64_t dropped = 0;     // requests cancelled or past their deadline before they were run
+        uint64_t batches = 0;
+        uint64_t texts = 0;
+        Histogram batchSizes{Histogram::exponential(1, 2, 10)}; // texts per session run
+        Histogram runMillis;      // inference time per session run
+        Histogram requestMillis;  // submission to result, queueing included
+        BatcherConfig limits;     // current limits, as moved by the autotuner when it is enabled
+        uint64_t autotuneDecisions = 0;
+        double autotuneP99Millis = 0; // request p99 of the autotuner's last window
+    };
+
+    // Held by the future of a request that was cancelled or whose deadline passed while it was queued.
+    class RequestDropped : public std::runtime_error {
+    public:
+        const InferenceStatus status;
+        explicit RequestDropped(InferenceStatus status);
+    };
+
+    struct AutotuneConfig;
+    class BatchAutotuner;
+
+    // Groups requests from many callers into shared session runs. Each model gets a
+    // dispatch thread that takes the oldest request, waits up to maxWait for more,
+    // then runs every queued request with the same decoding parameters that fits the
+    // batch and token limits. Requests with different label lists share a run through
+    // Model::inferencePerRow. The queue is bounded, so callers see back-pressure
+    // instead of unbounded latency. Requests that are cancelled or expire while queued
+    // are dropped when the next batch is taken; once in a running batch they complete.
+    class DynamicBatcher {
+    public:
+        using Result = std::vector<std::vector<Span>>;
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Request {
+            std::vector<std::string> texts;
+            std::vector<std::string> entities;
+            bool flatNer;
+            float threshold;
+            bool multiLabel;
+            size_t words;  // longest text, in whitespace-separated words
+            Clock::time_point submitted;
+            RequestControl control;
+            std::promise<Result> promise;
+        };
+        using Dropped = std::vector<std::pair<Request, InferenceStatus>>;
+
+        std::vector<Model*> models;
+        BatcherConfig config;
+        std::deque<Request> queue;
+        size_t queuedTexts = 0;
+        BatcherMetrics counters;
+        mutable std::mutex mutex;
+        std::condition_variable cv;
+        bool stopping = false;
+        std::unique_ptr<BatchAutotuner> autotuner;
+        std::vector<std::thread> threads;
+
+        void loop(Model& model);
+        std::vector<Request> takeBatch(Dropped& dropped); // with the mutex held
+    public:
+        explicit DynamicBatcher(std::vector<Model*> models, const BatcherConfig& config = BatcherConfig());
+        ~DynamicBatcher(); // runs the queued requests before joining
+        DynamicBatcher(const DynamicBatcher&) = delete;
+        DynamicBatcher& operator=(const DynamicBatcher&) = delete;
+
+        // Queues a request; returns false and leaves result untouched when the queue is full.
+        bool trySubmit(
+            std::vector<std::string> texts, std::vector<std::string> entities, std::future<Result>& result,
+            bool flatNer = true, float threshold = 0.5, bool multiLabel = false
+        );
+        // Controlled variant: a request cancelled or past its deadline before it is batched
+        // is not run, and its future throws RequestDropped with the status.
+        bool trySubmit(
+            std::vector<std::string> texts, std::vector<std::string> entities, RequestControl control,
+            std::future<Result>& result, bool flatNer = true, float threshold = 0.5, bool multiLabel = false
+        );
+
+        BatcherMetrics metrics() const;
+        BatcherConfig getConfig() const;
+        // Takes effect from the next batch; with autotuning on, tuning restarts from these limits.
+        void setConfig(const BatcherConfig& config);
+        // Lets a BatchAutotuner move maxBatchSize, maxTokens and maxWait to keep the request
+        // p99 under the target; the current limits are its starting point.
+        void enableAutotune(const AutotuneConfig& config);
+    };
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace gliner {
+    // Fixed-size pool of worker threads consuming a FIFO task queue.
+    class Executor {
+    private:
+        std::vector<std::thread> workers;
+        std::queue<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool stopping = false;
+
+        void workerLoop();
+    public:
+        explicit Executor(size_t numWorkers);
+        ~Executor(); // drains the queue before joining workers
+        Executor(const Executor&) = delete;
+        Executor& operator=(const Executor&) = delete;
+
+        void submit(std::function<void()> task);
+        size_t size() const;
+        size_t queued();
+    };
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "gliner_structs.hpp"
+
+namespace gliner {
+    struct GazetteerLabel {
+        std::string label;
+        std::vector<std::string> phrases;
+        float score = 1.0;    // probability given to every match
+        bool closed = false;  // the phrase list is complete: the label is dropped from the model prompt
+    };
+
+    struct GazetteerMatch {
+        size_t startWord;
+        size_t endWord;  // inclusive
+        uint32_t label;  // index into the labels the Gazetteer was built from
+    };
+
+    // Labels of one request split between the model and a Gazetteer.
+    struct GazetteerPlan {
+        std::vector<std::string> prompt;  // labels the model is run for
+        std::vector<std::string> labels;  // prompt followed by the closed labels dropped from it
+        std::vector<int> entityOf;        // gazetteer label -> index into labels, -1 when not requested
+        bool matches = false;             // whether any requested label has a phrase list
+    };
+
+    // Aho-Corasick automaton over word sequences. Phrases are split with the
+    // WhitespaceTokenSplitter, so they are matched against the same words the
+    // Processor feeds the model, and every occurrence of every phrase is found in
+    // one pass over the words of a text. Words are compared exactly, or with ASCII
+    // case folding. Immutable once built, so it can be shared between models.
+    class Gazetteer {
+    private:
+        struct Node {
+            uint32_t fail = 0;
+            uint32_t output = 0;  // nearest node on the fail chain where phrases end, 0: none
+            uint32_t depth = 0;   // words from the root
+            std::vector<uint32_t> labels; // labels of the phrases ending here
+        };
+
+        std::vector<std::string> names;
+        std::vector<float> scores;
+        std::vector<bool> closedLabels;
+        std::unordered_map<std::string, uint32_t> vocabulary;
+        std::unordered_map<uint64_t, uint32_t> edges; // node << 32 | word -> child node
+        std::vector<Node> nodes;
+        bool caseSensitive;
+
+        uint32_t wordId(std::string_view word, std::string& folded) const;
+        uint32_t child(uint32_t node, uint32_t word) const;
+    public:
+        explicit Gazetteer(const std::vector<GazetteerLabel>& labels, bool caseSensitive = false);
+
+        size_t numLabels() const;
+        const std::string& label(size_t id) const;
+        float score(size_t id) const;
+        bool closed(size_t id) const;
+        int labelId(const std::string& label) const; // -1 when there is no phrase list for the label
+
+        GazetteerPlan plan(const std::vector<std::string>& entities) const;
+        // Appends every phrase occurrence among `words`, whose offsets point into `text`.
+        void match(std::string_view text, const std::vector<Token>& words, std::vector<GazetteerMatch>& out) const;
+    };
+}
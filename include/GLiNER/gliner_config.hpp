@@ -1,14 +1,58 @@
 #pragma once
 
+#include <cstddef>
+#include <vector>
+
 namespace gliner {
     enum ModelType {
         TOKEN_LEVEL,
         SPAN_LEVEL
     };
 
+    enum ArenaExtendStrategy {
+        DEFAULT_EXTEND = -1,
+        NEXT_POWER_OF_TWO = 0,
+        SAME_AS_REQUESTED = 1
+    };
+
+    // ORT memory controls applied when the Model builds its session.
+    struct MemoryConfig {
+        bool memPattern = true;
+        bool cpuArena = true;
+        size_t maxArenaBytes = 0; // 0: no limit
+        ArenaExtendStrategy arenaExtendStrategy = DEFAULT_EXTEND;
+        size_t shrinkAboveBytes = 0; // shrink the arena after runs with at least this many input tensor bytes; 0: never
+    };
+
+    enum ModelFormat {
+        AUTO_FORMAT = 0,  // by the ORT flatbuffer file identifier
+        ONNX_FORMAT = 1,
+        ORT_FORMAT = 2
+    };
+
+    // How the Model reads its model file; see inspectModelFile for what a file holds.
+    struct LoadConfig {
+        ModelFormat format = AUTO_FORMAT;
+        bool mapOrtModel = true;  // ORT format: run from a memory map of the file, initializers included, instead of a copy
+        bool int8Qdq = false;     // QDQ-quantized models: keep int8 QDQ kernels on x86 (session.qdqisint8allowed)
+    };
+
+    // Synthetic input shape run by Model::warmup.
+    struct WarmupShape {
+        size_t batchSize;
+        size_t numTokens; // words per text
+        size_t numLabels;
+        size_t repeats = 3;
+    };
+
     struct Config {
         int maxWidth;
         int maxLength;
         ModelType modelType = SPAN_LEVEL;
+        size_t numWorkers = 1; // worker threads used by Model::inferenceAsync
+        bool useRunAsync = false; // hand session runs to Ort::Session::RunAsync (needs intra-op threads > 1)
+        MemoryConfig memory = {};
+        std::vector<WarmupShape> warmupShapes = {}; // run by the Model constructor when not empty
+        LoadConfig load = {};
     };
-}
\ No newline at end of file
+}
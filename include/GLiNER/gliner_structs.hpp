@@ -4,6 +4,8 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
+#include <memory_resource>
 #include <cstdint>
 
 namespace gliner {
@@ -13,52 +15,71 @@ namespace gliner {
         std::string text;
     };
 
+    // Subword ids of one word, owned by the caller.
+    struct SubwordIds {
+        const int32_t* data;
+        size_t size;
+    };
+
+    // A text already split into words upstream. Word offsets are byte offsets into
+    // the original text; the word text may be left empty when subwordIds are given.
+    // subwordIds is either empty (words are encoded by the tokenizer) or holds the
+    // ids of every word.
+    struct PretokenizedText {
+        std::vector<Token> words;
+        std::vector<std::vector<int32_t>> subwordIds;
+    };
+
+    // Views into the label list and the batch tokens; only valid while the batch is prepared.
     struct Prompt {
         int64_t textLength;
         int64_t promptLength;
-        std::vector<std::string> prompt;
+        std::pmr::vector<std::string_view> prompt;
+        const std::vector<SubwordIds>* textIds; // ids of the text words when already encoded, or nullptr
     };
 
+    // Buffers are plain vectors so that a batch object can be reused between calls
+    // without reallocating once it has grown to the working size.
     struct Batch {
-        int64_t batchSize;
-        int64_t numTokens;
-        int64_t numWords;
+        int64_t batchSize = 0;
+        int64_t numTokens = 0;
+        int64_t numWords = 0;
 
-        size_t inputsSize;
-        int64_t* inputsIds;
-        int64_t* attentionMasks;
-        int64_t* wordsMasks;
-        int64_t* inputsShape;
+        size_t inputsSize = 0;
+        std::vector<int64_t> inputsIds;
+        std::vector<int64_t> attentionMasks;
+        std::vector<int64_t> wordsMasks;
+        int64_t inputsShape[2] = {0, 0};
 
-        int64_t* textLengths;
-        int64_t* textLengthsShape;
+        std::vector<int64_t> textLengths;
+        int64_t textLengthsShape[2] = {0, 1};
         
         std::vector<std::vector<Token>> batchTokens;
 
-        virtual ~Batch();
+        virtual ~Batch() = default;
         virtual void tensors(std::vector<Ort::Value>& tensors, const Ort::MemoryInfo& memory_info) = 0;
         virtual int64_t width() const = 0;
     };
 
     struct TokenBatch : public Batch {
-        virtual ~TokenBatch();
+        virtual ~TokenBatch() = default;
         virtual void tensors(std::vector<Ort::Value>& tensors, const Ort::MemoryInfo& memory_info);
         virtual int64_t width() const;
     };
 
     struct SpanBatch : public Batch {
-        int64_t maxWidth;
-        int64_t numSpans;
-        int64_t spanIdxsSize;
-        int64_t spanMasksSize;
-        int64_t* spanIdxs;
-        int64_t* spanIdxsShape;
-        int64_t* spanMasksShape;
-        bool* spanMasks;
+        int64_t maxWidth = 0;
+        int64_t numSpans = 0;
+        int64_t spanIdxsSize = 0;
+        int64_t spanMasksSize = 0;
+        std::vector<int64_t> spanIdxs;
+        int64_t spanIdxsShape[3] = {0, 0, 2};
+        int64_t spanMasksShape[2] = {0, 0};
+        std::vector<uint8_t> spanMasks; // bool tensor data, one byte per element
 
         virtual void tensors(std::vector<Ort::Value>& tensors, const Ort::MemoryInfo& memory_info);
         virtual int64_t width() const;
-        virtual ~SpanBatch();
+        virtual ~SpanBatch() = default;
     };
 
     struct Span {
@@ -68,4 +89,4 @@ namespace gliner {
         std::string classLabel;
         float prob;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gliner_config.hpp"
+#include "gliner_structs.hpp"
+
+namespace gliner {
+    // Tensor memory of one session run. Only the input and output tensors are counted,
+    // not the activations ONNX Runtime allocates inside the run.
+    struct RunStats {
+        size_t inputBytes = 0;
+        size_t outputBytes = 0;
+        bool arenaShrunk = false; // arena chunks allocated by the run were released after it
+    };
+
+    // Output of a model run kept before decoding, so that it can be decoded
+    // again with other thresholds or flags without re-running the model.
+    struct InferenceResult {
+        ModelType modelType;
+        int64_t numWords;
+        int64_t width; // maxWidth for span-level models, numWords for token-level models
+        std::vector<std::string> texts;
+        std::vector<std::string> entities;
+        std::vector<std::vector<Token>> batchTokens;
+        std::vector<float> logits;
+        RunStats runStats;
+
+        // Compact binary form in native byte order. Token texts and run stats are not stored,
+        // they are restored from the texts and the token offsets.
+        void save(const std::string& path) const;
+        static InferenceResult load(const std::string& path);
+    };
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace gliner {
+    // Read-only memory mapping of a whole file; pages are loaded lazily by the OS.
+    class MappedFile {
+    private:
+        const char* mapping = nullptr;
+        size_t length = 0;
+#ifdef _WIN32
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#endif
+    public:
+        explicit MappedFile(const std::string& path);
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* data() const { return mapping; }
+        size_t size() const { return length; }
+        std::string_view view() const { return std::string_view(mapping, length); }
+    };
+}
@@ -4,28 +4,142 @@
 
 #include <vector>
 #include <string>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <condition_variable>
 
 #include "gliner_structs.hpp"
+#include "inference_result.hpp"
 #include "processor.hpp"
 #include "decoder.hpp"
+#include "executor.hpp"
+#include "result_cache.hpp"
+#include "cancellation.hpp"
+#include "token_shard.hpp"
+#include "mapped_file.hpp"
+#include "model_format.hpp"
+#include "gazetteer.hpp"
 
 
 namespace gliner {
+    using InferenceCallback = std::function<void(std::vector<std::vector<Span>>&&, std::exception_ptr)>;
+    using StatusCallback = std::function<void(InferenceStatus, std::vector<std::vector<Span>>&&, std::exception_ptr)>;
+
+    struct WarmupTiming {
+        WarmupShape shape;
+        std::vector<double> millis; // one entry per repeat
+
+        // Whether the last two repeats are within `tolerance` of each other.
+        bool stable(double tolerance = 0.1) const;
+    };
+
+    // Totals over the successful session runs of a Model; RunStats has the figures of one run.
+    struct MemoryStats {
+        size_t peakInputBytes;  // largest input tensor bytes of one run
+        size_t peakOutputBytes; // largest output tensor bytes of one run
+        uint64_t arenaShrinks;  // runs after which the arena was shrunk
+    };
+
     class Model {
     protected:
-        const std::string& modelPath;
+        std::string modelPath;
         Config config;
         Ort::Env *env = nullptr;
         Ort::SessionOptions *sessionOptions = nullptr;
         Ort::Session *session;
+        ModelFormat modelFormat = ONNX_FORMAT;
+        std::unique_ptr<MappedFile> modelBytes; // ORT format model the session runs from in place
         Processor *processor;
         Decoder *decoder;
         std::vector<const char*> inputNames;
         std::vector<const char*> outputNames;
 
+        std::mutex processorMutex; // WhitespaceTokenSplitter keeps per-instance match data
+        std::unique_ptr<Executor> executor;
+        std::once_flag executorFlag;
+        size_t pending = 0; // asynchronous requests not yet completed
+        std::mutex pendingMutex;
+        std::condition_variable pendingCv;
+        std::shared_ptr<ResultCache> cache;
+        std::string cacheModelId;
+        std::shared_ptr<const Gazetteer> gazetteer;
+        std::unique_ptr<Watchdog> watchdog;
+        std::once_flag watchdogFlag;
+        std::vector<WarmupTiming> warmupTimings;
+        std::atomic<size_t> peakInputBytes{0};
+        std::atomic<size_t> peakOutputBytes{0};
+        std::atomic<uint64_t> arenaShrinks{0};
+
         static bool checkInputs(const std::vector<std::string>& texts, const std::vector<std::string>& entities);
         void initialize(const std::string& tokenizer_path);
         void useDevice(Ort::SessionOptions* session_options, const int device_id);
+        void configureMemory(Ort::Env* env, Ort::SessionOptions& session_options);
+        void createSession(const Ort::Env& env, Ort::SessionOptions& session_options);
+        static size_t tensorBytes(const std::vector<Ort::Value>& tensors);
+        // Sets up the run options for a run with inputBytes of inputs; returns whether the arena is shrunk after it.
+        bool configureRun(Ort::RunOptions& run_options, size_t inputBytes);
+        void recordCall(const RunStats& stats); // after a successful run only
+        Batch* prepareBatch(const std::vector<std::string>& texts, const std::vector<std::string>& entities);
+        Batch* prepareBatch(const std::vector<std::string>& texts, const std::vector<std::vector<std::string>>& entities);
+        Batch* prepareBatch(
+            const std::vector<std::string>& texts, const std::vector<PretokenizedText>& words, const std::vector<std::string>& entities
+        );
+        Batch* prepareBatch(
+            std::vector<std::vector<Token>> words, const std::vector<std::vector<SubwordIds>>& textIds,
+            const std::vector<std::string>& entities
+        );
+        static void copyOutput(const Ort::Value& output_tensor, std::vector<float>& output);
+        InferenceStatus process(
+            const std::vector<std::string>& texts, const std::vector<std::string>& entities,
+            bool flatNer, float threshold, bool multiLabel,
+            const RequestControl* control, std::vector<std::vector<Span>>& output
+        );
+        InferenceStatus compute(
+            const std::vector<std::string>& texts, const std::vector<std::string>& entities,
+            bool flatNer, float threshold, bool multiLabel,
+            const RequestControl* control, std::vector<std::vector<Span>>& output
+        );
+        std::vector<std::vector<SpanCandidate>> gazetteerCandidates(
+            const std::vector<std::string>& texts, const std::vector<std::vector<Token>>& words,
+            const GazetteerPlan& plan, float threshold
+        ) const;
+        InferenceStatus runControlled(
+            const std::vector<Ort::Value>& input_tensors, std::vector<float>& output, const RequestControl& control,
+            RunStats* stats = nullptr
+        );
+        // Runs the session on the tensors of `batch`, under `control` when one is given.
+        InferenceStatus runBatch(
+            Batch& batch, std::vector<float>& logits, const RequestControl* control = nullptr, RunStats* stats = nullptr
+        );
+        Watchdog& getWatchdog();
+        Executor& getExecutor();
+        void beginRequest();
+        void endRequest();
+        // Ends a request started with beginRequest() when it goes out of scope, unless released.
+        class PendingRequest {
+        private:
+            Model* model;
+        public:
+            explicit PendingRequest(Model* model) : model(model) {}
+            ~PendingRequest() {
+                if (model != nullptr) {
+                    model->endRequest();
+                }
+            }
+            PendingRequest(const PendingRequest&) = delete;
+            PendingRequest& operator=(const PendingRequest&) = delete;
+            void release() { model = nullptr; }
+        };
+        struct AsyncRun;
+        static void onRunComplete(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatusPtr status);
+        void runAsync(
+            std::vector<std::string> texts, std::vector<std::string> entities, InferenceCallback callback,
+            bool flatNer, float threshold, bool multiLabel
+        );
     public:
         Model(
             const std::string& path, const std::string& tokenizer_path, const Config& config
@@ -41,9 +155,105 @@ namespace gliner {
 
         static int64_t count_total_elements(std::vector<int64_t>& output_shape);
         void run(const std::vector<Ort::Value>& input_tensors, std::vector<float>& output);
+        void run(
+            const std::vector<Ort::Value>& input_tensors, std::vector<float>& output, Ort::RunOptions& run_options,
+            RunStats* stats = nullptr
+        );
         std::vector<std::vector<Span>> inference(
             const std::vector<std::string>& texts, const std::vector<std::string>& entities, 
             bool flatNer = true, float threshold = 0.5, bool multiLabel = false
         );
+
+        // Inference bounded by a deadline and a cancellation token. Both are checked between
+        // pipeline stages and terminate the in-flight session run; a request stopped that way
+        // returns CANCELLED or DEADLINE_EXCEEDED with an empty output instead of throwing.
+        InferenceStatus inference(
+            const std::vector<std::string>& texts, const std::vector<std::string>& entities,
+            const RequestControl& control, std::vector<std::vector<Span>>& output,
+            bool flatNer = true, float threshold = 0.5, bool multiLabel = false
+        );
+
+        // Texts split into words (and optionally encoded) upstream: words[i] holds the word
+        // offsets into texts[i] and, optionally, the subword ids of every word. Word splitting
+        // and, where ids are given, subword encoding are skipped. It does not use the result cache.
+        std::vector<std::vector<Span>> inference(
+            const std::vector<std::string>& texts, const std::vector<PretokenizedText>& words,
+            const std::vector<std::string>& entities, bool flatNer = true, float threshold = 0.5, bool multiLabel = false
+        );
+
+        // Documents [begin, end) of a pre-tokenized shard as one batch; only the label
+        // prompt is encoded. Subword ids are read in place; texts and word offsets are
+        // copied out of the mapping for decoding. Throws std::invalid_argument when the
+        // shard was written with another tokenizer. It does not use the result cache.
+        std::vector<std::vector<Span>> inference(
+            const TokenShard& shard, size_t begin, size_t end, const std::vector<std::string>& entities,
+            bool flatNer = true, float threshold = 0.5, bool multiLabel = false
+        );
+
+        // Heterogeneous batch: entities[i] is the label list of texts[i], so requests with
+        // different label sets can share one session run. It does not use the result cache.
+        std::vector<std::vector<Span>> inferencePerRow(
+            const std::vector<std::string>& texts, const std::vector<std::vector<std::string>>& entities,
+            bool flatNer = true, float threshold = 0.5, bool multiLabel = false
+        );
+
+        // Columnar variant for bulk export: replaces `output` with the spans of the whole batch
+        // without building per-span strings. It does not use the result cache.
+        void inferenceColumns(
+            const std::vector<std::string>& texts, const std::vector<std::string>& entities, ColumnarSpans& output,
+            bool flatNer = true, float threshold = 0.5, bool multiLabel = false
+        );
+
+        // Two-phase inference: forward runs the model and keeps its logits, decode turns them into
+        // spans with any decoding parameters without running the model again.
+        InferenceResult forward(const std::vector<std::string>& texts, const std::vector<std::string>& entities);
+        std::vector<std::vector<Span>> decode(
+            const InferenceResult& result, bool flatNer = true, float threshold = 0.5, bool multiLabel = false
+        );
+
+        // Serves repeated texts from `cache`; model_id (the model path by default) is part of the key,
+        // so one cache can be shared between models. Pass nullptr to disable caching.
+        // Not synchronized with running requests: set it up before issuing inference calls.
+        void setCache(std::shared_ptr<ResultCache> cache, const std::string& model_id = "");
+
+        // Exact-match phrase lists run over the words of every text. Their matches join the
+        // model's span candidates before greedy selection, and labels with a closed list are
+        // left out of the prompt; when every requested label is closed the model is not run.
+        // Applies to inference and inferenceAsync; the other entry points run the model alone.
+        // Not synchronized with running requests, and cached results are not invalidated.
+        void setGazetteer(std::shared_ptr<const Gazetteer> gazetteer);
+
+        // Non-blocking variants: the request is queued on an internal executor with
+        // config.numWorkers threads and the result is delivered through a future or a callback.
+        // Callbacks run on worker or ONNX Runtime threads and should not throw; an exception
+        // escaping one is reported on stderr and dropped.
+        std::future<std::vector<std::vector<Span>>> inferenceAsync(
+            std::vector<std::string> texts, std::vector<std::string> entities,
+            bool flatNer = true, float threshold = 0.5, bool multiLabel = false
+        );
+        void inferenceAsync(
+            std::vector<std::string> texts, std::vector<std::string> entities, InferenceCallback callback,
+            bool flatNer = true, float threshold = 0.5, bool multiLabel = false
+        );
+        // Controlled variant; requests whose deadline passed while queued are shed without running.
+        void inferenceAsync(
+            std::vector<std::string> texts, std::vector<std::string> entities, RequestControl control, StatusCallback callback,
+            bool flatNer = true, float threshold = 0.5, bool multiLabel = false
+        );
+        // Runs synthetic batches of every shape so that ORT arenas, the tokenizer and the
+        // regex JIT are initialized before real traffic arrives, and returns their timings.
+        std::vector<WarmupTiming> warmup(const std::vector<WarmupShape>& shapes);
+        // Timings of the warm-up run by the constructor for config.warmupShapes.
+        const std::vector<WarmupTiming>& warmupReport() const;
+
+        // Format the model file was loaded as.
+        ModelFormat format() const;
+
+        // Tensor memory of the session runs so far, for bounding resident memory under bursty load.
+        // The figures of a single run are returned by run() and InferenceResult::runStats.
+        MemoryStats memoryStats() const;
+
+        // Blocks until every asynchronous request issued so far has completed.
+        void waitIdle();
     };
 }
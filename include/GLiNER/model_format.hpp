@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "gliner_config.hpp"
+
+namespace gliner {
+    struct ModelFileInfo {
+        ModelFormat format = ONNX_FORMAT;
+        size_t bytes = 0;
+        std::vector<std::string> quantizedOps; // quantization operator types used by the graph
+
+        bool quantized() const { return !quantizedOps.empty(); }
+    };
+
+    // ORT_FORMAT when the file carries the ORT flatbuffer identifier, ONNX_FORMAT otherwise.
+    ModelFormat detectModelFormat(const std::string& path);
+
+    // Format, size and quantization operators of a model file. The whole file is
+    // scanned for the operator names, so this is meant for tools, not for every load.
+    ModelFileInfo inspectModelFile(const std::string& path);
+
+    const char* formatName(ModelFormat format);
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <onnxruntime_cxx_api.h>
+
+#include <array>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gliner_config.hpp"
+#include "gliner_structs.hpp"
+#include "processor.hpp"
+#include "decoder.hpp"
+
+namespace gliner {
+    template <ModelType Type>
+    struct PipelineTraits;
+
+    template <>
+    struct PipelineTraits<SPAN_LEVEL> {
+        using ProcessorType = SpanProcessor;
+        using DecoderType = SpanDecoder;
+        using BatchType = SpanBatch;
+        static constexpr std::array<const char*, 6> inputNames = {
+            "input_ids", "attention_mask", "words_mask", "text_lengths", "span_idx", "span_mask"
+        };
+    };
+
+    template <>
+    struct PipelineTraits<TOKEN_LEVEL> {
+        using ProcessorType = TokenProcessor;
+        using DecoderType = TokenDecoder;
+        using BatchType = TokenBatch;
+        static constexpr std::array<const char*, 4> inputNames = {
+            "input_ids", "attention_mask", "words_mask", "text_lengths"
+        };
+    };
+
+    // Inference pipeline specialized at compile time on the model type and, for
+    // span-level models, optionally on a fixed maxWidth (0 keeps config.maxWidth).
+    // Pre-processing, tensor construction and decoding are bound statically and the
+    // batch and output buffers are reused between calls, so a pipeline must not be
+    // shared between threads: create one per worker over a shared Ort::Session.
+    template <ModelType Type, int64_t MaxWidth = 0>
+    class Pipeline {
+    private:
+        using Traits = PipelineTraits<Type>;
+        static_assert(MaxWidth >= 0, "MaxWidth must be positive, or 0 for the runtime width");
+        static_assert(Type == SPAN_LEVEL || MaxWidth == 0, "MaxWidth only applies to span-level models");
+
+        Config config;
+        Ort::Session& session;
+        typename Traits::ProcessorType processor;
+        typename Traits::DecoderType decoder;
+        typename Traits::BatchType batch;
+        Ort::MemoryInfo memoryInfo;
+        std::vector<Ort::Value> inputTensors;
+        std::vector<float> output;
+
+        static Config adjust(Config config) {
+            config.modelType = Type;
+            if (MaxWidth > 0) {
+                config.maxWidth = MaxWidth;
+            }
+            return config;
+        }
+
+        void run() {
+            const char* outputNames[] = {"logits"};
+            std::vector<Ort::Value> modelOutputs = session.Run(
+                Ort::RunOptions(), Traits::inputNames.data(),
+                inputTensors.data(), Traits::inputNames.size(),
+                outputNames, 1
+            );
+            Ort::TensorTypeAndShapeInfo output_info = modelOutputs[0].GetTensorTypeAndShapeInfo();
+            const float* output_data = modelOutputs[0].template GetTensorData<float>();
+            output.assign(output_data, output_data + output_info.GetElementCount());
+        }
+
+    public:
+        Pipeline(Ort::Session& session, const std::string& tokenizer_path, const Config& config)
+            : config(adjust(config)),
+              session(session),
+              processor(this->config, tokenizer_path),
+              memoryInfo(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)) {}
+
+        Pipeline(const Pipeline&) = delete;
+        Pipeline& operator=(const Pipeline&) = delete;
+
+        std::vector<std::vector<Span>> inference(
+            const std::vector<std::string>& texts, const std::vector<std::string>& entities,
+            bool flatNer = true, float threshold = 0.5, bool multiLabel = false
+        ) {
+            if (texts.empty() || entities.empty()) {
+                std::cerr << "WARNING! Empty texts or entities." << std::endl;
+                return {};
+            }
+
+            processor.Traits::ProcessorType::prepareBatch(texts, entities, batch);
+            inputTensors.clear();
+            batch.Traits::BatchType::tensors(inputTensors, memoryInfo);
+            run();
+
+            if constexpr (Type == SPAN_LEVEL) {
+                return decoder.template decodeSpans<MaxWidth>(
+                    batch.batchTokens, batch.numWords, batch.maxWidth, texts, entities, output, flatNer, threshold, multiLabel
+                );
+            } else {
+                return decoder.TokenDecoder::decodeOutput(
+                    batch.batchTokens, batch.numWords, batch.numWords, texts, entities, output, flatNer, threshold, multiLabel
+                );
+            }
+        }
+    };
+
+    using SpanPipeline = Pipeline<SPAN_LEVEL>;
+    using TokenPipeline = Pipeline<TOKEN_LEVEL>;
+}
@@ -8,46 +8,120 @@
 #include "gliner_config.hpp"
 #include "gliner_structs.hpp"
 #include "tokenizer_utils.hpp"
+#include "arena.hpp"
 
 namespace gliner {
     class Processor {
     protected:
         Config config;
         std::unique_ptr<tokenizers::Tokenizer> tokenizer;
+        uint64_t fingerprint = 0;
         WhitespaceTokenSplitter wordSplitter;
 
-        void encodeInputs(const std::vector<Prompt>& prompts, Batch* output);
-        virtual void prepareTextInputs(
-            const std::vector<std::string>& entities, Batch* output, std::vector<Prompt>& prompts
+        void encodeInputs(const std::pmr::vector<Prompt>& prompts, Batch* output);
+        static void appendEntitiesPrompt(const std::vector<std::string>& entities, std::pmr::vector<std::string_view>& prompt);
+        static void resetTextInputs(Batch* output);
+        static void setWords(std::vector<std::vector<Token>> words, Batch* output);
+        static void attachTextIds(const std::vector<std::vector<SubwordIds>>& textIds, std::pmr::vector<Prompt>& prompts);
+        static void addPrompt(
+            size_t row, const std::pmr::vector<std::string_view>& entities_prompt, Batch* output, std::pmr::vector<Prompt>& prompts
+        );
+        // Not virtual: the statically bound fillBatch and Pipeline paths call it directly.
+        void prepareTextInputs(
+            const std::vector<std::string>& entities, Batch* output, std::pmr::vector<Prompt>& prompts
+        );
+        // One label list per text; the model pads the label dimension to the longest list.
+        void prepareTextInputs(
+            const std::vector<std::vector<std::string>>& entities, Batch* output, std::pmr::vector<Prompt>& prompts
         );
     public:
         Processor(const Config& config, const std::string& tokenizer_path);
         virtual ~Processor() {};
+        uint64_t tokenizerFingerprint() const; // TokenizerFingerprint of the tokenizer file
         std::vector<Token> tokenizeText(const std::string& text);
         std::vector<std::vector<Token>> batchTokenizeText(const std::vector<std::string>& texts);
         
         virtual Batch* prepareBatch(
             const std::vector<std::string>& texts, const std::vector<std::string>& entities
         ) = 0; 
+        virtual Batch* prepareBatch(
+            const std::vector<std::string>& texts, const std::vector<std::vector<std::string>>& entities
+        ) = 0;
+        // Words split (and optionally encoded) upstream; no word splitting, and no subword
+        // encoding for texts with subword ids. Span offsets still refer to texts.
+        Batch* prepareBatch(
+            const std::vector<std::string>& texts, const std::vector<PretokenizedText>& words, const std::vector<std::string>& entities
+        );
+        // Same from word offsets and id views: textIds is empty or has one entry per row,
+        // holding the ids of every word of the row, or nothing to encode the word texts.
+        virtual Batch* prepareBatch(
+            std::vector<std::vector<Token>> words, const std::vector<std::vector<SubwordIds>>& textIds,
+            const std::vector<std::string>& entities
+        ) = 0;
     };
 
     class SpanProcessor : public Processor {
     protected:
-        void prepareSpans(const std::vector<Prompt>& prompts, SpanBatch* output);
+        void prepareSpans(const std::pmr::vector<Prompt>& prompts, SpanBatch* output);
+        // Builds the inputs of the words already set on output.
+        template <typename Labels>
+        void fillBatch(const Labels& entities, SpanBatch& output, const std::vector<std::vector<SubwordIds>>* textIds);
     public:
+        using Processor::prepareBatch;
         SpanProcessor(const Config& config, const std::string& tokenizer_path);
         virtual ~SpanProcessor() {};
         virtual Batch* prepareBatch(
             const std::vector<std::string>& texts, const std::vector<std::string>& entities
         ); 
+        virtual Batch* prepareBatch(
+            const std::vector<std::string>& texts, const std::vector<std::vector<std::string>>& entities
+        );
+        // Fills a caller-owned batch; its buffers are reused when it is passed again.
+        void prepareBatch(
+            const std::vector<std::string>& texts, const std::vector<std::string>& entities, SpanBatch& output
+        );
+        void prepareBatch(
+            const std::vector<std::string>& texts, const std::vector<std::vector<std::string>>& entities, SpanBatch& output
+        );
+        virtual Batch* prepareBatch(
+            std::vector<std::vector<Token>> words, const std::vector<std::vector<SubwordIds>>& textIds,
+            const std::vector<std::string>& entities
+        );
+        void prepareBatch(
+            std::vector<std::vector<Token>> words, const std::vector<std::vector<SubwordIds>>& textIds,
+            const std::vector<std::string>& entities, SpanBatch& output
+        );
     };
 
     class TokenProcessor : public Processor {
+    protected:
+        // Builds the inputs of the words already set on output.
+        template <typename Labels>
+        void fillBatch(const Labels& entities, TokenBatch& output, const std::vector<std::vector<SubwordIds>>* textIds);
     public:
+        using Processor::prepareBatch;
         TokenProcessor(const Config& config, const std::string& tokenizer_path);
         virtual ~TokenProcessor() {};
         virtual Batch* prepareBatch(
             const std::vector<std::string>& texts, const std::vector<std::string>& entities
         ); 
+        virtual Batch* prepareBatch(
+            const std::vector<std::string>& texts, const std::vector<std::vector<std::string>>& entities
+        );
+        // Fills a caller-owned batch; its buffers are reused when it is passed again.
+        void prepareBatch(
+            const std::vector<std::string>& texts, const std::vector<std::string>& entities, TokenBatch& output
+        );
+        void prepareBatch(
+            const std::vector<std::string>& texts, const std::vector<std::vector<std::string>>& entities, TokenBatch& output
+        );
+        virtual Batch* prepareBatch(
+            std::vector<std::vector<Token>> words, const std::vector<std::vector<SubwordIds>>& textIds,
+            const std::vector<std::string>& entities
+        );
+        void prepareBatch(
+            std::vector<std::vector<Token>> words, const std::vector<std::vector<SubwordIds>>& textIds,
+            const std::vector<std::string>& entities, TokenBatch& output
+        );
     };
 }
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <onnxruntime_cxx_api.h>
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gliner_config.hpp"
+#include "gliner_structs.hpp"
+#include "executor.hpp"
+#include "model.hpp"
+
+namespace gliner {
+    // Model handle whose instance can be replaced while it serves traffic.
+    // reload() builds and warms the new session, processor and tokenizer on a
+    // background thread, then publishes it with an atomic pointer swap. Calls
+    // keep the instance they started on alive through a shared_ptr, and the
+    // retired instance is destroyed on the background thread once they drain:
+    // the last holder only hands it back, it does not run the destructor.
+    class ReloadableModel {
+    private:
+        using Released = std::future<std::unique_ptr<Model>>;
+
+        Config config;
+        const Ort::Env* env = nullptr;
+        const Ort::SessionOptions* sessionOptions = nullptr;
+        std::shared_ptr<Model> current;
+        Released currentReleased; // ready once every holder of current has let go
+        std::atomic<uint64_t> currentVersion{1};
+        Executor reloader{1}; // serializes reloads
+
+        std::unique_ptr<Model> build(const std::string& model_path, const std::string& tokenizer_path) const;
+        static std::shared_ptr<Model> publish(std::unique_ptr<Model> model, Released& released);
+    public:
+        ReloadableModel(const std::string& model_path, const std::string& tokenizer_path, const Config& config);
+        // env and session_options are reused for every reload and must outlive the handle.
+        ReloadableModel(
+            const std::string& model_path, const std::string& tokenizer_path, const Config& config,
+            const Ort::Env& env, const Ort::SessionOptions& session_options
+        );
+        ~ReloadableModel(); // waits for pending reloads
+        ReloadableModel(const ReloadableModel&) = delete;
+        ReloadableModel& operator=(const ReloadableModel&) = delete;
+
+        // Current instance; it stays valid for as long as the caller holds it. Release it
+        // promptly: the reloader frees a retired instance only after every holder has.
+        std::shared_ptr<Model> acquire() const;
+        std::vector<std::vector<Span>> inference(
+            const std::vector<std::string>& texts, const std::vector<std::string>& entities,
+            bool flatNer = true, float threshold = 0.5, bool multiLabel = false
+        );
+
+        // Loads a new version in the background. The future is ready once it serves traffic;
+        // if loading fails it carries the error and the previous version stays in place.
+        std::future<void> reload(const std::string& model_path, const std::string& tokenizer_path);
+        // Incremented by every successful reload, starting at 1.
+        uint64_t version() const;
+    };
+}
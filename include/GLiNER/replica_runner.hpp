@@ -0,0 +1,102 @@
+#pragma once
+
+#include <onnxruntime_cxx_api.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gliner_config.hpp"
+#include "gliner_structs.hpp"
+#include "model.hpp"
+
+namespace gliner {
+    struct ReplicaConfig {
+        size_t numReplicas = 1;
+        int threadsPerReplica = 0; // 0 splits the available cores evenly between replicas
+        bool pinThreads = true;    // pin each replica's intra-op threads to its own cores
+        bool numaLocal = false;    // keep every replica, and the memory it touches first, on one NUMA node
+    };
+
+    struct ReplicaStats {
+        std::vector<int> cores;
+        int numaNode; // -1 when unknown
+        uint64_t batches;
+        uint64_t texts;
+    };
+
+    // K independent session replicas over disjoint core sets. Each replica has a
+    // dispatch thread pinned to its first core that also runs intra-op thread 0; the
+    // remaining intra-op threads are pinned through session.intra_op_thread_affinities.
+    // Batches go to a shared FIFO queue and are pulled by whichever replica is idle.
+    class ReplicaRunner {
+    private:
+        struct Request {
+            std::vector<std::string> texts;
+            std::vector<std::string> entities;
+            bool flatNer;
+            float threshold;
+            bool multiLabel;
+            std::promise<std::vector<std::vector<Span>>> promise;
+        };
+
+        struct Replica {
+            std::vector<int> cores;
+            int numaNode = -1;
+            std::unique_ptr<Model> model;
+            std::deque<Request> own; // requests for this replica only, taken before the shared queue
+            std::thread thread;
+            std::atomic<uint64_t> batches{0};
+            std::atomic<uint64_t> texts{0};
+        };
+
+        Ort::Env env;
+        std::vector<std::unique_ptr<Replica>> replicas;
+        std::deque<Request> queue;
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool stopping = false;
+
+        void start(
+            Replica& replica, const std::string& model_path, const std::string& tokenizer_path,
+            const Config& config, bool pinThreads, std::promise<void>& ready
+        );
+        void loop(Replica& replica);
+        void stop();
+    public:
+        ReplicaRunner(
+            const std::string& model_path, const std::string& tokenizer_path, const Config& config, const ReplicaConfig& replicaConfig
+        );
+        ~ReplicaRunner(); // drains the queue before joining replicas
+        ReplicaRunner(const ReplicaRunner&) = delete;
+        ReplicaRunner& operator=(const ReplicaRunner&) = delete;
+
+        std::future<std::vector<std::vector<Span>>> submit(
+            std::vector<std::string> texts, std::vector<std::string> entities,
+            bool flatNer = true, float threshold = 0.5, bool multiLabel = false
+        );
+        std::vector<std::vector<Span>> inference(
+            const std::vector<std::string>& texts, const std::vector<std::string>& entities,
+            bool flatNer = true, float threshold = 0.5, bool multiLabel = false
+        );
+        // Runs the batch once on every replica, bypassing the shared queue, and waits for all of them.
+        void warmup(const std::vector<std::string>& texts, const std::vector<std::string>& entities);
+
+        size_t size() const;
+        std::vector<ReplicaStats> stats() const;
+
+        // Logical CPUs this process may run on, grouped by NUMA node (one group when unknown).
+        static std::vector<std::vector<int>> numaNodes();
+        // Splits the available CPUs into numReplicas disjoint sets; numaLocal keeps each set on one node.
+        static std::vector<std::vector<int>> partitionCores(size_t numReplicas, int threadsPerReplica, bool numaLocal);
+        // Value for session.intra_op_thread_affinities: one 1-based group per thread after the caller's.
+        static std::string affinityEntry(const std::vector<int>& cores);
+    };
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "gliner_structs.hpp"
+
+namespace gliner {
+    // 128-bit content hash of (text, labels, decoding parameters, model id).
+    struct CacheKey {
+        uint64_t hi;
+        uint64_t lo;
+
+        bool operator==(const CacheKey& other) const {
+            return hi == other.hi && lo == other.lo;
+        }
+    };
+
+    struct CacheKeyHash {
+        size_t operator()(const CacheKey& key) const {
+            return static_cast<size_t>(key.lo);
+        }
+    };
+
+    struct CacheStats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t insertions;
+        uint64_t evictions;
+        size_t entries;
+        size_t bytes;
+
+        double hitRate() const {
+            uint64_t total = hits + misses;
+            return total == 0 ? 0.0 : double(hits) / double(total);
+        }
+    };
+
+    // Size-bounded, sharded LRU cache of decoded spans per text.
+    // Every shard has its own lock and an equal share of the byte budget.
+    // Entries keep their text, which is compared on every hit, so two texts whose
+    // keys collide never share results; the labels, decoding parameters and model
+    // id are compared through their 128-bit paramsKey only.
+    class ResultCache {
+    private:
+        struct Entry {
+            CacheKey key;
+            std::string text;
+            std::vector<Span> spans;
+            size_t bytes;
+        };
+
+        struct Shard {
+            std::mutex mutex;
+            std::list<Entry> lru; // most recently used first
+            std::unordered_map<CacheKey, std::list<Entry>::iterator, CacheKeyHash> index;
+            size_t bytes = 0;
+        };
+
+        std::vector<std::unique_ptr<Shard>> shards;
+        size_t shardCapacity;
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+        std::atomic<uint64_t> insertions{0};
+        std::atomic<uint64_t> evictions{0};
+
+        Shard& shardFor(const CacheKey& key);
+        static size_t entryBytes(std::string_view text, const std::vector<Span>& spans);
+    public:
+        explicit ResultCache(size_t maxBytes, size_t numShards = 16);
+        ResultCache(const ResultCache&) = delete;
+        ResultCache& operator=(const ResultCache&) = delete;
+
+        // Hash of everything but the text; computed once per inference call.
+        static CacheKey paramsKey(
+            const std::vector<std::string>& entities, float threshold, bool flatNer, bool multiLabel, const std::string& modelId
+        );
+        static CacheKey textKey(std::string_view text, const CacheKey& params);
+
+        // key must be textKey(text, ...); a stored entry for another text is a miss.
+        bool get(const CacheKey& key, std::string_view text, std::vector<Span>& spans);
+        void put(const CacheKey& key, std::string_view text, const std::vector<Span>& spans);
+        void clear();
+        CacheStats stats();
+    };
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <tokenizers_cpp.h>
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gliner_structs.hpp"
+#include "mapped_file.hpp"
+#include "tokenizer_utils.hpp"
+
+namespace gliner {
+    // Writes documents with their words and subword ids, as the Processor would
+    // produce them, to a binary shard that TokenShard maps back. Documents are
+    // streamed out one by one; the document index is written by finish().
+    class TokenShardWriter {
+    private:
+        std::ofstream out;
+        std::string path;
+        std::unique_ptr<tokenizers::Tokenizer> tokenizer;
+        WhitespaceTokenSplitter wordSplitter;
+        std::vector<uint64_t> offsets;
+        uint64_t position = 0;
+        bool finished = false;
+
+        void write(const void* data, size_t size);
+        void pad(size_t alignment);
+    public:
+        TokenShardWriter(const std::string& path, const std::string& tokenizer_path);
+        ~TokenShardWriter(); // finishes the shard unless finish() was called
+        TokenShardWriter(const TokenShardWriter&) = delete;
+        TokenShardWriter& operator=(const TokenShardWriter&) = delete;
+
+        void add(const std::string& text);
+        void finish();
+        size_t size() const;
+    };
+
+    // Memory-mapped shard written by TokenShardWriter. Texts, word offsets and
+    // subword ids are read in place, so preparing a batch from a shard skips word
+    // splitting and subword encoding and only encodes the label prompt.
+    //
+    // Layout, native byte order: "GLTS", uint32 version, uint64 fingerprint of
+    // the tokenizer file (TokenizerFingerprint), then one record per
+    // document at an 8-byte aligned offset: uint32 numWords, numIds, textBytes,
+    // padding, the text padded to 4 bytes, uint32 wordStarts[numWords],
+    // uint32 wordEnds[numWords], uint32 wordIds[numWords] (ids per word),
+    // int32 ids[numIds]. The file ends with uint64 recordOffsets[numDocs],
+    // uint64 numDocs and "GLTS".
+    class TokenShard {
+    private:
+        struct Record {
+            uint32_t numWords;
+            uint32_t numIds;
+            uint32_t textBytes;
+            uint32_t reserved;
+        };
+
+        MappedFile file;
+        const uint64_t* recordOffsets = nullptr;
+        size_t numDocs = 0;
+        uint64_t fingerprint = 0;
+
+        const Record& record(size_t doc) const;
+        const uint32_t* wordStarts(size_t doc) const;
+    public:
+        explicit TokenShard(const std::string& path);
+
+        size_t size() const;
+        // Identifies the tokenizer the ids were encoded with; compared with the model's before inference.
+        uint64_t tokenizerFingerprint() const;
+        std::string_view text(size_t doc) const;
+        size_t numWords(size_t doc) const;
+        size_t numTokens(size_t doc) const;
+        // Word offsets into text(doc); the token texts are left empty.
+        std::vector<Token> words(size_t doc) const;
+        // Subword ids of every word, pointing into the mapping.
+        std::vector<SubwordIds> subwordIds(size_t doc) const;
+    };
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
 #include "gliner_structs.hpp"
@@ -19,5 +20,7 @@ public:
 };
 
 std::string LoadBytesFromFile(const std::string& path);
+// FNV-1a hash of a serialized tokenizer, to tell apart data encoded by different tokenizers.
+uint64_t TokenizerFingerprint(const std::string& blob);
 
 }
\ No newline at end of file
@@ -0,0 +1,39 @@
+#include <algorithm>
+
+#include "GLiNER/arena.hpp"
+
+using namespace gliner;
+
+void* Arena::CountingResource::do_allocate(size_t bytes, size_t alignment) {
+    allocated += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void Arena::CountingResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+bool Arena::CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+Arena::Arena(size_t initialCapacity, size_t maxCapacity)
+    : buffer(new std::byte[initialCapacity]), capacity(initialCapacity), maxCapacity(std::max(initialCapacity, maxCapacity)) {
+    monotonic.emplace(buffer.get(), capacity, &upstream);
+}
+
+void Arena::reset() {
+    monotonic.reset(); // releases overflow blocks back to upstream
+    if (upstream.allocated > 0 && capacity < maxCapacity) {
+        // Grow the initial block to cover the whole request next time, but not past the cap.
+        capacity = std::min(capacity + upstream.allocated, maxCapacity);
+        buffer.reset(new std::byte[capacity]);
+    }
+    upstream.allocated = 0;
+    monotonic.emplace(buffer.get(), capacity, &upstream);
+}
+
+Arena& Arena::local() {
+    thread_local Arena arena;
+    return arena;
+}
@@ -0,0 +1,88 @@
+#include <algorithm>
+
+#include "GLiNER/autotuner.hpp"
+
+using namespace gliner;
+
+namespace {
+    const double DECAY = 0.98; // weight of older runs in the latency fit
+}
+
+BatchAutotuner::BatchAutotuner(const AutotuneConfig& config, const BatcherConfig& initial)
+    : config(config), limits(initial), windowLatency(Histogram::exponential(0.25, 1.2, 64)) {
+    this->config.minBatchSize = std::max<size_t>(1, config.minBatchSize);
+    this->config.maxBatchSize = std::max(this->config.minBatchSize, config.maxBatchSize);
+    this->config.window = std::max<size_t>(1, config.window);
+    limits.maxBatchSize = std::clamp(limits.maxBatchSize, this->config.minBatchSize, this->config.maxBatchSize);
+    limits.maxWait = std::min(limits.maxWait, this->config.maxWait);
+}
+
+bool BatchAutotuner::observe(
+    size_t texts, size_t words, double runMillis, const std::vector<double>& requestMillis, size_t backlog
+) {
+    double x = double(texts * std::max<size_t>(1, words));
+    sw = sw * DECAY + 1;
+    sx = sx * DECAY + x;
+    sy = sy * DECAY + runMillis;
+    sxx = sxx * DECAY + x * x;
+    sxy = sxy * DECAY + x * runMillis;
+
+    for (double millis : requestMillis) {
+        windowLatency.record(millis);
+    }
+    windowRuns++;
+    bool full = texts >= limits.maxBatchSize || (limits.maxTokens > 0 && x + x / texts > double(limits.maxTokens));
+    windowBacklog += full || backlog > 0;
+    if (windowRuns < config.window) {
+        return false;
+    }
+
+    BatcherConfig before = limits;
+    decide();
+    windowLatency.clear();
+    windowRuns = 0;
+    windowBacklog = 0;
+    return before.maxBatchSize != limits.maxBatchSize || before.maxTokens != limits.maxTokens ||
+           before.maxWait != limits.maxWait;
+}
+
+void BatchAutotuner::decide() {
+    tuned.decisions++;
+    tuned.windowP99Millis = windowLatency.quantile(0.99);
+
+    double meanX = sx / sw;
+    double variance = sxx / sw - meanX * meanX;
+    if (variance > 1e-9 * meanX * meanX && variance > 0) {
+        tuned.perTokenMillis = std::max(0.0, (sxy / sw - meanX * sy / sw) / variance);
+        tuned.runFixedMillis = std::max(0.0, sy / sw - tuned.perTokenMillis * meanX);
+    } else { // a single batch shape so far: no fixed part can be told apart
+        tuned.perTokenMillis = meanX > 0 ? sy / sx : 0;
+        tuned.runFixedMillis = 0;
+    }
+
+    double runBudget = config.targetP99Millis * config.runShare - tuned.runFixedMillis;
+    if (tuned.perTokenMillis > 0 && runBudget > 0) {
+        limits.maxTokens = std::max<size_t>(1, size_t(runBudget / tuned.perTokenMillis));
+    }
+
+    using Micros = std::chrono::microseconds;
+    if (tuned.windowP99Millis > config.targetP99Millis) {
+        limits.maxBatchSize = std::max(config.minBatchSize, limits.maxBatchSize * 7 / 10);
+        limits.maxWait = Micros(limits.maxWait.count() / 2);
+    } else if (tuned.windowP99Millis < config.targetP99Millis * config.headroom && windowBacklog * 2 >= windowRuns) {
+        limits.maxBatchSize = std::min(config.maxBatchSize, limits.maxBatchSize + std::max<size_t>(1, limits.maxBatchSize / 8));
+        limits.maxWait = std::min(config.maxWait, Micros(limits.maxWait.count() + limits.maxWait.count() / 4 + 100));
+    }
+}
+
+const AutotuneConfig& BatchAutotuner::settings() const {
+    return config;
+}
+
+const BatcherConfig& BatchAutotuner::current() const {
+    return limits;
+}
+
+const AutotuneState& BatchAutotuner::state() const {
+    return tuned;
+}
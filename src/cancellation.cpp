@@ -0,0 +1,94 @@
+#include <algorithm>
+
+#include "GLiNER/cancellation.hpp"
+
+using namespace gliner;
+
+CancellationToken::CancellationToken() : state(std::make_shared<State>()) {}
+
+void CancellationToken::cancel() {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->cancelled = true;
+    for (Ort::RunOptions* run : state->runs) {
+        run->SetTerminate();
+    }
+}
+
+bool CancellationToken::isCancelled() const {
+    return state->cancelled;
+}
+
+void CancellationToken::attach(Ort::RunOptions* run_options) {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (state->cancelled) {
+        run_options->SetTerminate();
+    }
+    state->runs.push_back(run_options);
+}
+
+void CancellationToken::detach(Ort::RunOptions* run_options) {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->runs.erase(std::remove(state->runs.begin(), state->runs.end(), run_options), state->runs.end());
+}
+
+RequestControl RequestControl::withTimeout(Clock::duration timeout) {
+    RequestControl control;
+    control.deadline = Clock::now() + timeout;
+    return control;
+}
+
+InferenceStatus RequestControl::check() const {
+    if (cancellation.isCancelled()) {
+        return InferenceStatus::CANCELLED;
+    }
+    if (deadline != Clock::time_point::max() && Clock::now() >= deadline) {
+        return InferenceStatus::DEADLINE_EXCEEDED;
+    }
+    return InferenceStatus::OK;
+}
+
+Watchdog::Watchdog() : thread(&Watchdog::loop, this) {}
+
+Watchdog::~Watchdog() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    thread.join();
+}
+
+void Watchdog::loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        if (runs.empty()) {
+            cv.wait(lock);
+            continue;
+        }
+        auto first = runs.begin();
+        if (Clock::now() >= first->first) {
+            first->second->SetTerminate(); // under the lock, so unwatch() cannot race with it
+            runs.erase(first);
+            continue;
+        }
+        cv.wait_until(lock, first->first);
+    }
+}
+
+void Watchdog::watch(Clock::time_point deadline, Ort::RunOptions* run_options) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        runs.emplace(deadline, run_options);
+    }
+    cv.notify_all();
+}
+
+void Watchdog::unwatch(Ort::RunOptions* run_options) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = runs.begin(); it != runs.end(); ++it) {
+        if (it->second == run_options) {
+            runs.erase(it);
+            return;
+        }
+    }
+}
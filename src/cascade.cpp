@@ -0,0 +1,67 @@
+#include <algorithm>
+
+#include "GLiNER/cascade.hpp"
+
+using namespace gliner;
+
+Cascade::Cascade(Model& small, Model& large, const CascadeConfig& config)
+    : small(small), large(large), config(config) {}
+
+std::vector<std::vector<Span>> Cascade::inference(
+    const std::vector<std::string>& texts, const std::vector<std::string>& entities,
+    bool flatNer, float threshold, bool multiLabel, std::vector<size_t>* escalations
+) {
+    if (escalations != nullptr) {
+        escalations->clear();
+    }
+    // The small model's logits are kept, so probing the band below the threshold costs only a decode.
+    InferenceResult first = small.forward(texts, entities);
+    std::vector<std::vector<Span>> results = small.decode(first, flatNer, threshold, multiLabel);
+    if (results.empty()) {
+        return results; // empty texts or entities
+    }
+    std::vector<std::vector<Span>> relaxed = small.decode(
+        first, flatNer, std::max(0.0f, threshold - config.band), multiLabel
+    );
+
+    std::vector<size_t> uncertain = uncertainTexts(results, relaxed, threshold, config);
+
+    if (!uncertain.empty()) {
+        std::vector<std::string> hardTexts;
+        hardTexts.reserve(uncertain.size());
+        for (size_t id : uncertain) {
+            hardTexts.push_back(texts[id]);
+        }
+        auto refined = large.inference(hardTexts, entities, flatNer, threshold, multiLabel);
+        for (size_t k = 0; k < uncertain.size(); ++k) {
+            results[uncertain[k]] = std::move(refined[k]);
+        }
+    }
+
+    this->texts += texts.size();
+    escalated += uncertain.size();
+    if (escalations != nullptr) {
+        *escalations = std::move(uncertain);
+    }
+    return results;
+}
+
+std::vector<size_t> Cascade::uncertainTexts(
+    const std::vector<std::vector<Span>>& results, const std::vector<std::vector<Span>>& relaxed,
+    float threshold, const CascadeConfig& config
+) {
+    std::vector<size_t> uncertain;
+    for (size_t i = 0; i < results.size(); ++i) {
+        bool inBand = std::any_of(relaxed[i].begin(), relaxed[i].end(), [&](const Span& span) {
+            return span.prob < threshold + config.band;
+        });
+        if (inBand || (config.escalateEmpty && results[i].empty())) {
+            uncertain.push_back(i);
+        }
+    }
+    return uncertain;
+}
+
+CascadeStats Cascade::stats() const {
+    return {texts.load(), escalated.load()};
+}
@@ -0,0 +1,167 @@
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "GLiNER/columnar_spans.hpp"
+
+using namespace gliner;
+
+namespace {
+    const char MAGIC[4] = {'G', 'L', 'C', 'S'};
+    const uint32_t VERSION = 1;
+
+    template <typename T>
+    void write(std::ostream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    void writeColumn(std::ostream& out, const std::vector<T>& column) {
+        out.write(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(T));
+    }
+
+    template <typename T>
+    T read(std::ifstream& in) {
+        T value;
+        if (!in.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+            throw std::runtime_error("Unexpected end of columnar spans file");
+        }
+        return value;
+    }
+
+    // Reads an element count and checks that that many elements of elementBytes fit in the
+    // rest of the file, so a corrupt count fails before anything is allocated for it.
+    uint64_t readCount(std::ifstream& in, uint64_t fileSize, uint64_t elementBytes) {
+        uint64_t count = read<uint64_t>(in);
+        if (count > (fileSize - uint64_t(in.tellg())) / elementBytes) {
+            throw std::runtime_error("Corrupt columnar spans file: count exceeds the file size");
+        }
+        return count;
+    }
+
+    template <typename T>
+    void readColumn(std::ifstream& in, std::vector<T>& column, size_t size) {
+        column.resize(size);
+        if (!in.read(reinterpret_cast<char*>(column.data()), size * sizeof(T))) {
+            throw std::runtime_error("Unexpected end of columnar spans file");
+        }
+    }
+}
+
+size_t ColumnarSpans::size() const {
+    return row.size();
+}
+
+size_t ColumnarSpans::rows() const {
+    return rowOffsets.empty() ? 0 : rowOffsets.size() - 1;
+}
+
+void ColumnarSpans::clear() {
+    labels.clear();
+    rowOffsets.clear();
+    row.clear();
+    start.clear();
+    end.clear();
+    labelId.clear();
+    prob.clear();
+}
+
+std::vector<std::vector<Span>> ColumnarSpans::toSpans(const std::vector<std::string>& texts) const {
+    if (texts.size() != rows()) {
+        throw std::invalid_argument("Expected one text per row of the columnar spans");
+    }
+    std::vector<std::vector<Span>> out(rows());
+    for (size_t r = 0; r < out.size(); ++r) {
+        out[r].reserve(rowOffsets[r + 1] - rowOffsets[r]);
+        for (size_t i = rowOffsets[r]; i < rowOffsets[r + 1]; ++i) {
+            if (size_t(end[i]) > texts[r].size()) {
+                throw std::invalid_argument("Columnar span ends past the end of its text");
+            }
+            out[r].push_back({start[i], end[i], texts[r].substr(start[i], end[i] - start[i]), labels[labelId[i]], prob[i]});
+        }
+    }
+    return out;
+}
+
+void ColumnarSpans::write(std::ostream& out) const {
+    out.write(MAGIC, sizeof(MAGIC));
+    ::write(out, VERSION);
+    ::write<uint64_t>(out, labels.size());
+    for (const auto& label : labels) {
+        ::write<uint64_t>(out, label.size());
+        out.write(label.data(), label.size());
+    }
+    ::write<uint64_t>(out, rowOffsets.size());
+    ::write<uint64_t>(out, size());
+    writeColumn(out, rowOffsets);
+    writeColumn(out, row);
+    writeColumn(out, start);
+    writeColumn(out, end);
+    writeColumn(out, labelId);
+    writeColumn(out, prob);
+}
+
+void ColumnarSpans::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::out | std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    write(out);
+    if (!out) {
+        throw std::runtime_error("Failed to write file: " + path);
+    }
+}
+
+ColumnarSpans ColumnarSpans::load(const std::string& path) {
+    std::ifstream in(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!in) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    uint64_t fileSize = uint64_t(in.tellg());
+    in.seekg(0);
+
+    char magic[sizeof(MAGIC)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not a columnar spans file: " + path);
+    }
+    if (read<uint32_t>(in) != VERSION) {
+        throw std::runtime_error("Unsupported columnar spans version: " + path);
+    }
+
+    ColumnarSpans spans;
+    spans.labels.resize(readCount(in, fileSize, sizeof(uint64_t)));
+    for (auto& label : spans.labels) {
+        label.resize(readCount(in, fileSize, 1));
+        if (!in.read(&label[0], label.size())) {
+            throw std::runtime_error("Unexpected end of columnar spans file");
+        }
+    }
+    size_t numOffsets = readCount(in, fileSize, sizeof(uint64_t));
+    size_t numSpans = readCount(in, fileSize, 5 * sizeof(uint32_t));
+    readColumn(in, spans.rowOffsets, numOffsets);
+    readColumn(in, spans.row, numSpans);
+    readColumn(in, spans.start, numSpans);
+    readColumn(in, spans.end, numSpans);
+    readColumn(in, spans.labelId, numSpans);
+    readColumn(in, spans.prob, numSpans);
+
+    // Row offsets start at 0, never decrease and end at the span count; every span lies in
+    // the row its offsets place it in and has a valid label and range.
+    if (numOffsets == 0 ? numSpans != 0 : (spans.rowOffsets.front() != 0 || spans.rowOffsets.back() != numSpans)) {
+        throw std::runtime_error("Corrupt columnar spans file: row offsets do not cover the spans");
+    }
+    for (size_t r = 0; r + 1 < numOffsets; ++r) {
+        if (spans.rowOffsets[r] > spans.rowOffsets[r + 1]) {
+            throw std::runtime_error("Corrupt columnar spans file: row offsets decrease");
+        }
+    }
+    for (size_t r = 0; r + 1 < numOffsets; ++r) {
+        for (size_t i = spans.rowOffsets[r]; i < spans.rowOffsets[r + 1]; ++i) {
+            if (spans.row[i] != r || spans.labelId[i] >= spans.labels.size() ||
+                spans.start[i] < 0 || spans.start[i] > spans.end[i]) {
+                throw std::runtime_error("Corrupt columnar spans file: span out of range");
+            }
+        }
+    }
+    return spans;
+}
@@ -1,63 +1,96 @@
-#include <cmath>
+#include <algorithm>
+#include <tuple>
 
 #include "GLiNER/decoder.hpp"
 
 using namespace gliner;
 
-float sigmoid(float x) {
-    return 1.0 / (1.0 + std::exp(-x));
-}
+std::vector<Span> Decoder::greedySearch(
+    const std::vector<Span>& spans, bool flatNer, bool multiLabel
+) { // expected sorted spans by start/end position
+    std::vector<size_t> selected;
+    greedySelect(spans.data(), spans.size(), flatNer, multiLabel, selected);
 
-bool Decoder::isNested(const Span& s1, const Span& s2) {
-    return (s1.startIdx <= s2.startIdx && s2.endIdx <= s1.endIdx) || (s2.startIdx <= s1.startIdx && s1.endIdx <= s2.endIdx);
+    std::vector<Span> newList;
+    newList.reserve(selected.size());
+    for (size_t id : selected) {
+        newList.push_back(spans[id]);
+    }
+    return newList;
 }
 
-// Check for any overlap between two spans
-bool Decoder::hasOverlapping(const Span& s1, const Span& s2, bool multiLabel) {
-    if (s1.startIdx == s2.startIdx && s1.endIdx == s2.endIdx) {
-        return !multiLabel;
-    }
-    if (s1.startIdx > s2.endIdx || s2.startIdx > s1.endIdx) {
-        return false;
+template <typename LabelsOf>
+std::vector<std::vector<Span>> Decoder::selectRows(
+    const CandidateRows& candidates,
+    const std::vector<std::string>& texts,
+    LabelsOf labelsOf,
+    bool flatNer,
+    bool multiLabel
+) { // expected sorted candidates by start/end position in batches
+    Arena& arena = Arena::local();
+    Arena::Scope scope(arena);
+    std::pmr::vector<size_t> selected(arena.resource());
+
+    std::vector<std::vector<Span>> allSelectedSpans(candidates.size());
+    for (size_t b = 0; b < candidates.size(); ++b) {
+        const auto& row = candidates[b];
+        const std::vector<std::string>& entities = labelsOf(b);
+        selected.clear();
+        greedySelect(row.data(), row.size(), flatNer, multiLabel, selected);
+
+        auto& out = allSelectedSpans[b];
+        out.reserve(selected.size());
+        for (size_t id : selected) {
+            const SpanCandidate& c = row[id];
+            out.push_back({
+                c.startIdx,
+                c.endIdx,
+                texts[b].substr(c.startIdx, c.endIdx - c.startIdx),
+                entities[c.entity],
+                c.prob
+            });
+        }
     }
-    return true;
+    return allSelectedSpans;
 }
 
-// Check if spans overlap but are not nested inside each other
-bool Decoder::hasOverlappingNested(const Span& s1, const Span& s2, bool multiLabel) {
-    return hasOverlapping(s1, s2, multiLabel) || isNested(s1, s2);
+std::vector<std::vector<Span>> Decoder::selectSpans(
+    const CandidateRows& candidates,
+    const std::vector<std::string>& texts,
+    const std::vector<std::string>& entities,
+    bool flatNer,
+    bool multiLabel
+) {
+    return selectRows(candidates, texts, [&entities](size_t) -> const std::vector<std::string>& {
+        return entities;
+    }, flatNer, multiLabel);
 }
 
-std::vector<Span> Decoder::greedySearch(
-    const std::vector<Span>& spans, bool flatNer, bool multiLabel
-) { // expected sorted spans by start/end position
-    if (spans.empty()) {
-        return {};
-    }
+void Decoder::selectColumns(
+    const CandidateRows& candidates,
+    bool flatNer,
+    bool multiLabel,
+    ColumnarSpans& out
+) { // expected sorted candidates by start/end position in batches
+    Arena& arena = Arena::local();
+    Arena::Scope scope(arena);
+    std::pmr::vector<size_t> selected(arena.resource());
 
-    std::function<bool(const Span&, const Span&, bool)> hasOv;
-    if (flatNer) {
-        hasOv = hasOverlapping;
-    } else {
-        hasOv = hasOverlappingNested;
-    }
+    for (size_t b = 0; b < candidates.size(); ++b) {
+        const auto& row = candidates[b];
+        selected.clear();
+        greedySelect(row.data(), row.size(), flatNer, multiLabel, selected);
 
-    std::vector<Span> newList;
-    newList.reserve(spans.size());
-
-    size_t prev = 0, next = 1;
-    for (; next < spans.size(); next++) {
-        if (!hasOv(spans[prev], spans[next], multiLabel)) {
-            newList.push_back(spans[prev]);
-            prev = next;
-        } else {
-            if (spans[prev].prob < spans[next].prob) { // get span with higher score on overlap
-                prev = next;
-            }
+        for (size_t id : selected) {
+            const SpanCandidate& c = row[id];
+            out.row.push_back(uint32_t(b));
+            out.start.push_back(c.startIdx);
+            out.end.push_back(c.endIdx);
+            out.labelId.push_back(uint32_t(c.entity));
+            out.prob.push_back(c.prob);
         }
+        out.rowOffsets.push_back(out.row.size());
     }
-    newList.push_back(spans[prev]);
-    return newList;
 }
 
 std::vector<std::vector<Span>> Decoder::batchGreedySearch(
@@ -73,7 +106,7 @@ std::vector<std::vector<Span>> Decoder::batchGreedySearch(
     return allSelectedSpans;
 }
 
-std::vector<std::vector<Span>> SpanDecoder::decode(
+std::vector<std::vector<Span>> Decoder::decode(
     const Batch* batch,
     const std::vector<std::string>& texts,
     const std::vector<std::string>& entities,
@@ -82,63 +115,187 @@ std::vector<std::vector<Span>> SpanDecoder::decode(
     float threshold,
     bool multiLabel
 ) {
-    auto tokens = batch->batchTokens;
-    int batchSize = batch->batchSize;
-    int inputLength = batch->numWords;
-    int numEntities = entities.size();
-
-    int startTokenPadding = batch->width() * numEntities;
-    int batchPadding = inputLength * startTokenPadding;
-    int endTokenPadding = numEntities;
-
-    std::vector<std::vector<Span>> spans(batchSize);
-    // Process the model output
-    for (size_t id = 0; id < modelOutput.size(); ++id) {
-        float value = modelOutput[id];
-        int batch_id = id / batchPadding;
-        size_t startToken = (id / startTokenPadding) % inputLength;
-        size_t endToken = startToken + ((id / endTokenPadding) % batch->width());
-        int entity = id % numEntities; // always one of entities
-        float prob = sigmoid(value);
-        
-        if (prob >= threshold &&
-            batch_id < batchSize &&
-            startToken < tokens[batch_id].size() &&
-            endToken < tokens[batch_id].size()) {
-
-            Span span;
-            span.startIdx = tokens[batch_id][startToken].start;
-            span.endIdx = tokens[batch_id][endToken].end;
-            span.text = texts[batch_id].substr(span.startIdx, span.endIdx - span.startIdx);
-            span.classLabel = entities[entity];
-            span.prob = prob;
-
-            spans[batch_id].push_back(span);
-        }
+    return decodeOutput(
+        batch->batchTokens, batch->numWords, batch->width(), texts, entities, modelOutput, flatNer, threshold, multiLabel
+    );
+}
+
+std::vector<std::vector<Span>> Decoder::decode(
+    const Batch* batch,
+    const std::vector<std::string>& texts,
+    const std::vector<std::vector<std::string>>& entities,
+    const std::vector<float>& modelOutput,
+    bool flatNer,
+    float threshold,
+    bool multiLabel
+) {
+    size_t numEntities = 0;
+    for (const auto& labels : entities) {
+        numEntities = std::max(numEntities, labels.size());
     }
 
-    return batchGreedySearch(spans, flatNer, multiLabel);
+    Arena& arena = Arena::local();
+    Arena::Scope scope(arena);
+    CandidateRows spans(batch->batchTokens.size(), arena.resource());
+    collectCandidates(batch->batchTokens, batch->numWords, batch->width(), numEntities, modelOutput, threshold, spans);
+    for (size_t b = 0; b < spans.size(); ++b) {
+        int rowEntities = entities[b].size();
+        auto& row = spans[b];
+        row.erase(std::remove_if(row.begin(), row.end(), [rowEntities](const SpanCandidate& c) {
+            return c.entity >= rowEntities; // padded label slot
+        }), row.end());
+    }
+    return selectRows(spans, texts, [&entities](size_t b) -> const std::vector<std::string>& {
+        return entities[b];
+    }, flatNer, multiLabel);
 }
 
-std::vector<std::vector<Span>> TokenDecoder::decode(
+std::vector<std::vector<Span>> Decoder::decodeMerged(
     const Batch* batch,
     const std::vector<std::string>& texts,
     const std::vector<std::string>& entities,
+    size_t numModelEntities,
+    const std::vector<float>& modelOutput,
+    const std::vector<std::vector<SpanCandidate>>& extra,
+    bool flatNer,
+    float threshold,
+    bool multiLabel
+) {
+    Arena& arena = Arena::local();
+    Arena::Scope scope(arena);
+    CandidateRows spans(texts.size(), arena.resource());
+    if (batch != nullptr) {
+        collectCandidates(batch->batchTokens, batch->numWords, batch->width(), numModelEntities, modelOutput, threshold, spans);
+    }
+    for (size_t b = 0; b < spans.size(); ++b) {
+        auto& row = spans[b];
+        if (extra[b].empty()) {
+            continue;
+        }
+        row.insert(row.end(), extra[b].begin(), extra[b].end());
+        std::stable_sort(row.begin(), row.end(), [](const SpanCandidate& x, const SpanCandidate& y) {
+            return std::tie(x.startIdx, x.endIdx, x.entity) < std::tie(y.startIdx, y.endIdx, y.entity);
+        });
+        // One candidate per span and label, with the higher of the two scores.
+        size_t kept = 0;
+        for (size_t i = 0; i < row.size(); ++i) {
+            if (kept > 0 && row[kept - 1].startIdx == row[i].startIdx && row[kept - 1].endIdx == row[i].endIdx &&
+                row[kept - 1].entity == row[i].entity) {
+                row[kept - 1].prob = std::max(row[kept - 1].prob, row[i].prob);
+                continue;
+            }
+            row[kept++] = row[i];
+        }
+        row.erase(row.begin() + kept, row.end());
+    }
+    return selectSpans(spans, texts, entities, flatNer, multiLabel);
+}
+
+std::vector<std::vector<Span>> Decoder::decode(
+    const InferenceResult& result,
+    bool flatNer,
+    float threshold,
+    bool multiLabel
+) {
+    return decodeOutput(
+        result.batchTokens, result.numWords, result.width, result.texts, result.entities, result.logits, flatNer, threshold, multiLabel
+    );
+}
+
+void Decoder::decodeColumns(
+    const std::vector<std::vector<Token>>& batchTokens,
+    int64_t numWords,
+    int64_t width,
+    const std::vector<std::string>& entities,
+    const std::vector<float>& modelOutput,
+    ColumnarSpans& out,
+    bool flatNer,
+    float threshold,
+    bool multiLabel
+) {
+    out.clear();
+    out.labels = entities;
+    out.rowOffsets.push_back(0);
+
+    Arena& arena = Arena::local();
+    Arena::Scope scope(arena);
+    CandidateRows spans(batchTokens.size(), arena.resource());
+    collectCandidates(batchTokens, numWords, width, entities.size(), modelOutput, threshold, spans);
+    selectColumns(spans, flatNer, multiLabel, out);
+}
+
+void Decoder::decodeColumns(
+    const InferenceResult& result,
+    ColumnarSpans& out,
+    bool flatNer,
+    float threshold,
+    bool multiLabel
+) {
+    decodeColumns(
+        result.batchTokens, result.numWords, result.width, result.entities, result.logits, out, flatNer, threshold, multiLabel
+    );
+}
+
+void SpanDecoder::collectCandidates(
+    const std::vector<std::vector<Token>>& tokens,
+    int64_t numWords,
+    int64_t width,
+    int numEntities,
+    const std::vector<float>& modelOutput,
+    float threshold,
+    CandidateRows& spans
+) {
+    collectSpans<0>(tokens, numWords, width, numEntities, modelOutput, threshold, spans);
+}
+
+std::vector<std::vector<Span>> SpanDecoder::decodeOutput(
+    const std::vector<std::vector<Token>>& tokens,
+    int64_t numWords,
+    int64_t width,
+    const std::vector<std::string>& texts,
+    const std::vector<std::string>& entities,
     const std::vector<float>& modelOutput,
     bool flatNer,
     float threshold,
     bool multiLabel
 ) {
-    auto tokens = batch->batchTokens;
-    int batchSize = batch->batchSize;
-    int inputLength = batch->numWords;
-    int numEntities = entities.size();
+    return decodeSpans<0>(tokens, numWords, width, texts, entities, modelOutput, flatNer, threshold, multiLabel);
+}
+
+std::vector<std::vector<Span>> TokenDecoder::decodeOutput(
+    const std::vector<std::vector<Token>>& tokens,
+    int64_t numWords,
+    int64_t width,
+    const std::vector<std::string>& texts,
+    const std::vector<std::string>& entities,
+    const std::vector<float>& modelOutput,
+    bool flatNer,
+    float threshold,
+    bool multiLabel
+) {
+    Arena& arena = Arena::local();
+    Arena::Scope scope(arena);
+    CandidateRows spans(tokens.size(), arena.resource());
+    TokenDecoder::collectCandidates(tokens, numWords, width, entities.size(), modelOutput, threshold, spans);
+    return selectSpans(spans, texts, entities, flatNer, multiLabel);
+}
+
+void TokenDecoder::collectCandidates(
+    const std::vector<std::vector<Token>>& tokens,
+    int64_t numWords,
+    int64_t /*width*/,
+    int numEntities,
+    const std::vector<float>& modelOutput,
+    float threshold,
+    CandidateRows& spans
+) {
+    int batchSize = tokens.size();
+    int inputLength = numWords;
 
     int batchPadding = inputLength * numEntities;
     int positionPadding = batchSize * batchPadding;
     int tokenPadding = numEntities;
 
-    std::vector<std::vector<Span>> spans(batchSize);
     for (size_t start_id = 0; start_id < static_cast<size_t>(positionPadding); start_id++) {
         if (
             sigmoid(modelOutput[start_id]) < threshold 
@@ -166,16 +323,12 @@ std::vector<std::vector<Span>> TokenDecoder::decode(
             score_sum += score;
             ++n;
 
-            Span span;
-            span.startIdx = tokens[batch_id][startToken].start;
-            span.endIdx = tokens[batch_id][endToken].end;
-            span.text = texts[batch_id].substr(span.startIdx, span.endIdx - span.startIdx);
-            span.classLabel = entities[entity];
-            span.prob = score_sum / n;
-
-            spans[batch_id].push_back(span);
+            spans[batch_id].push_back({
+                int(tokens[batch_id][startToken].start),
+                int(tokens[batch_id][endToken].end),
+                entity,
+                score_sum / n
+            });
         }
     }
-
-    return batchGreedySearch(spans, flatNer, multiLabel);
-}
\ No newline at end of file
+}
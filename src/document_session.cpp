@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <string_view>
+
+#include "GLiNER/document_session.hpp"
+
+using namespace gliner;
+
+namespace {
+    uint64_t wordHash(const std::string& word) {
+        uint64_t h = 0xcbf29ce484222325ULL; // FNV-1a
+        for (unsigned char c : word) {
+            h = (h ^ c) * 0x100000001b3ULL;
+        }
+        return h;
+    }
+
+    bool isNaturalBoundary(const std::string& text, const std::vector<Token>& words, size_t j) {
+        const std::string& word = words[j].text;
+        if (word == "." || word == "!" || word == "?") {
+            return true;
+        }
+        if (j + 1 < words.size()) {
+            size_t gap = words[j].end;
+            size_t next = words[j + 1].start;
+            if (std::string_view(text).substr(gap, next - gap).find('\n') != std::string_view::npos) {
+                return true;
+            }
+        }
+        return (wordHash(word) & 15) == 0;
+    }
+}
+
+Chunker::Chunker(const ChunkConfig& config) : config(config) {
+    this->config.maxWords = std::max<size_t>(1, config.maxWords);
+    this->config.minWords = std::min(config.minWords, this->config.maxWords);
+}
+
+std::vector<DocumentWindow> Chunker::split(const std::string& text) {
+    std::vector<Token> words = splitter.call(text);
+    std::vector<DocumentWindow> out;
+    if (words.empty()) {
+        return out;
+    }
+
+    size_t n = words.size();
+    size_t begin = 0;
+    for (size_t j = 0; j < n; ++j) {
+        size_t length = j + 1 - begin;
+        bool last = j + 1 == n;
+        if (!last && length < config.maxWords && (length < config.minWords || !isNaturalBoundary(text, words, j))) {
+            continue;
+        }
+        size_t end = j + 1;
+        size_t contextBegin = begin > config.overlapWords ? begin - config.overlapWords : 0;
+        size_t contextEnd = std::min(n, end + config.overlapWords);
+        out.push_back({
+            begin == 0 ? 0 : words[begin].start,
+            last ? text.size() : words[end].start,
+            words[contextBegin].start,
+            words[contextEnd - 1].end
+        });
+        begin = end;
+    }
+    return out;
+}
+
+DocumentSession::DocumentSession(
+    Model& model, std::vector<std::string> entities, const ChunkConfig& config, bool flatNer, float threshold, bool multiLabel
+) : model(model), entities(std::move(entities)), flatNer(flatNer), threshold(threshold), multiLabel(multiLabel),
+    chunker(config), batchSize(std::max<size_t>(1, config.batchSize)) {
+    params = ResultCache::paramsKey(this->entities, threshold, flatNer, multiLabel, "");
+}
+
+const std::vector<Span>& DocumentSession::update(const std::string& text) {
+    std::vector<DocumentWindow> layout = chunker.split(text);
+
+    // The key covers the window text and where its core lies inside it, since both decide the owned spans.
+    std::vector<CacheKey> keys;
+    keys.reserve(layout.size());
+    for (const auto& window : layout) {
+        size_t bounds[2] = {window.coreStart - window.contextStart, window.coreEnd - window.contextStart};
+        CacheKey core = ResultCache::textKey(
+            std::string_view(reinterpret_cast<const char*>(bounds), sizeof(bounds)), params
+        );
+        keys.push_back(ResultCache::textKey(
+            std::string_view(text).substr(window.contextStart, window.contextEnd - window.contextStart), core
+        ));
+    }
+
+    std::unordered_map<CacheKey, std::vector<Span>, CacheKeyHash> next;
+    std::vector<size_t> missing;
+    for (size_t w = 0; w < layout.size(); ++w) {
+        if (next.count(keys[w])) {
+            continue; // repeated content inside this document
+        }
+        auto it = windows.find(keys[w]);
+        if (it != windows.end()) {
+            next.emplace(keys[w], std::move(it->second));
+        } else {
+            next.emplace(keys[w], std::vector<Span>());
+            missing.push_back(w);
+        }
+    }
+
+    for (size_t b = 0; b < missing.size(); b += batchSize) {
+        size_t end = std::min(missing.size(), b + batchSize);
+        std::vector<std::string> texts;
+        for (size_t k = b; k < end; ++k) {
+            const DocumentWindow& window = layout[missing[k]];
+            texts.push_back(text.substr(window.contextStart, window.contextEnd - window.contextStart));
+        }
+        auto results = model.inference(texts, entities, flatNer, threshold, multiLabel);
+        for (size_t k = b; k < end; ++k) {
+            const DocumentWindow& window = layout[missing[k]];
+            std::vector<Span>& owned = next[keys[missing[k]]];
+            for (auto& span : results[k - b]) {
+                size_t start = window.contextStart + span.startIdx;
+                if (start >= window.coreStart && start < window.coreEnd) {
+                    owned.push_back(std::move(span));
+                }
+            }
+        }
+    }
+
+    current.clear();
+    for (size_t w = 0; w < layout.size(); ++w) {
+        for (const auto& span : next[keys[w]]) {
+            Span shifted = span;
+            shifted.startIdx += int(layout[w].contextStart);
+            shifted.endIdx += int(layout[w].contextStart);
+            current.push_back(std::move(shifted));
+        }
+    }
+    std::stable_sort(current.begin(), current.end(), [](const Span& a, const Span& b) {
+        return a.startIdx != b.startIdx ? a.startIdx < b.startIdx : a.endIdx < b.endIdx;
+    });
+
+    // A span running into the next window's core may clash with one that window owns.
+    if (flatNer && !current.empty()) {
+        size_t kept = 0;
+        for (size_t i = 1; i < current.size(); ++i) {
+            Span& prev = current[kept];
+            bool sameRange = prev.startIdx == current[i].startIdx && prev.endIdx == current[i].endIdx;
+            bool overlap = current[i].startIdx < prev.endIdx && !(multiLabel && sameRange);
+            if (!overlap) {
+                if (++kept != i) {
+                    current[kept] = std::move(current[i]);
+                }
+            } else if (current[i].prob > prev.prob) {
+                prev = std::move(current[i]);
+            }
+        }
+        current.resize(kept + 1);
+    }
+
+    windows = std::move(next);
+    numWindows = layout.size();
+    numRerun = missing.size();
+    return current;
+}
+
+const std::vector<Span>& DocumentSession::spans() const {
+    return current;
+}
+
+size_t DocumentSession::windowCount() const {
+    return numWindows;
+}
+
+size_t DocumentSession::rerunCount() const {
+    return numRerun;
+}
@@ -0,0 +1,322 @@
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+#include "GLiNER/dynamic_batcher.hpp"
+#include "GLiNER/autotuner.hpp"
+
+using namespace gliner;
+
+namespace {
+    size_t countWords(const std::string& text) {
+        size_t words = 0;
+        bool inWord = false;
+        for (unsigned char c : text) {
+            bool space = std::isspace(c);
+            words += !space && !inWord;
+            inWord = !space;
+        }
+        return words;
+    }
+
+    double millisSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+Histogram::Histogram(std::vector<double> bounds)
+    : upperBounds(std::move(bounds)), bucketCounts(upperBounds.size() + 1, 0) {
+    std::sort(upperBounds.begin(), upperBounds.end());
+}
+
+void Histogram::record(double value) {
+    size_t bucket = std::lower_bound(upperBounds.begin(), upperBounds.end(), value) - upperBounds.begin();
+    bucketCounts[bucket]++;
+    total++;
+    totalSum += value;
+}
+
+void Histogram::clear() {
+    std::fill(bucketCounts.begin(), bucketCounts.end(), 0);
+    total = 0;
+    totalSum = 0;
+}
+
+uint64_t Histogram::count() const {
+    return total;
+}
+
+double Histogram::sum() const {
+    return totalSum;
+}
+
+double Histogram::quantile(double q) const {
+    if (total == 0 || upperBounds.empty()) {
+        return 0;
+    }
+    uint64_t rank = std::max<uint64_t>(1, uint64_t(q * total + 0.999999));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < upperBounds.size(); ++i) {
+        seen += bucketCounts[i];
+        if (seen >= rank) {
+            return upperBounds[i];
+        }
+    }
+    return upperBounds.back();
+}
+
+const std::vector<double>& Histogram::bounds() const {
+    return upperBounds;
+}
+
+const std::vector<uint64_t>& Histogram::counts() const {
+    return bucketCounts;
+}
+
+std::vector<double> Histogram::exponential(double start, double factor, size_t n) {
+    std::vector<double> out;
+    out.reserve(n);
+    for (double bound = start; out.size() < n; bound *= factor) {
+        out.push_back(bound);
+    }
+    return out;
+}
+
+RequestDropped::RequestDropped(InferenceStatus status)
+    : std::runtime_error(status == InferenceStatus::CANCELLED ? "Request was cancelled" : "Request deadline exceeded"),
+      status(status) {}
+
+DynamicBatcher::DynamicBatcher(std::vector<Model*> models, const BatcherConfig& config)
+    : models(std::move(models)), config(config) {
+    if (this->models.empty()) {
+        throw std::invalid_argument("DynamicBatcher needs at least one model");
+    }
+    this->config.maxBatchSize = std::max<size_t>(1, config.maxBatchSize);
+    for (Model* model : this->models) {
+        threads.emplace_back(&DynamicBatcher::loop, this, std::ref(*model));
+    }
+}
+
+DynamicBatcher::~DynamicBatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+bool DynamicBatcher::trySubmit(
+    std::vector<std::string> texts, std::vector<std::string> entities, std::future<Result>& result,
+    bool flatNer, float threshold, bool multiLabel
+) {
+    return trySubmit(std::move(texts), std::move(entities), RequestControl(), result, flatNer, threshold, multiLabel);
+}
+
+bool DynamicBatcher::trySubmit(
+    std::vector<std::string> texts, std::vector<std::string> entities, RequestControl control,
+    std::future<Result>& result, bool flatNer, float threshold, bool multiLabel
+) {
+    if (texts.empty() || entities.empty()) {
+        throw std::invalid_argument("Empty texts or entities");
+    }
+    size_t words = 0;
+    for (const auto& text : texts) {
+        words = std::max(words, countWords(text));
+    }
+    Request request{std::move(texts), std::move(entities), flatNer, threshold, multiLabel, words, Clock::now(), std::move(control), {}};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) {
+            throw std::runtime_error("DynamicBatcher is stopped");
+        }
+        // A request larger than the whole queue is still let in when the queue is empty.
+        if (queuedTexts > 0 && queuedTexts + request.texts.size() > config.maxQueueTexts) {
+            counters.rejected++;
+            return false;
+        }
+        result = request.promise.get_future();
+        queuedTexts += request.texts.size();
+        counters.requests++;
+        queue.push_back(std::move(request));
+    }
+    cv.notify_all();
+    return true;
+}
+
+std::vector<DynamicBatcher::Request> DynamicBatcher::takeBatch(Dropped& dropped) {
+    std::vector<Request> batch;
+    std::deque<Request> rest;
+    size_t rows = 0, words = 0, expired = 0;
+    bool flatNer = false, multiLabel = false, full = false;
+    float threshold = 0;
+    for (auto& request : queue) {
+        InferenceStatus status = request.control.check();
+        if (status != InferenceStatus::OK) {
+            expired += request.texts.size();
+            dropped.emplace_back(std::move(request), status);
+            continue;
+        }
+        if (batch.empty()) {
+            // The oldest live request sets the decoding parameters of the batch.
+            flatNer = request.flatNer;
+            threshold = request.threshold;
+            multiLabel = request.multiLabel;
+        }
+        bool compatible = request.flatNer == flatNer && request.threshold == threshold && request.multiLabel == multiLabel;
+        if (compatible && !full) {
+            size_t nextRows = rows + request.texts.size();
+            size_t nextWords = std::max(words, request.words);
+            bool fits = nextRows <= config.maxBatchSize && (config.maxTokens == 0 || nextRows * nextWords <= config.maxTokens);
+            if (batch.empty() || fits) {
+                rows = nextRows;
+                words = nextWords;
+                batch.push_back(std::move(request));
+                continue;
+            }
+            full = true; // keep arrival order: later requests do not overtake this one
+        }
+        rest.push_back(std::move(request));
+    }
+    queue.swap(rest);
+    queuedTexts -= rows + expired;
+    counters.dropped += dropped.size();
+    return batch;
+}
+
+void DynamicBatcher::loop(Model& model) {
+    while (true) {
+        std::vector<Request> batch;
+        Dropped dropped;
+        size_t backlog = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return; // stopping and nothing left to run
+            }
+            // Give a partial batch until maxWait after its oldest request to fill up.
+            while (!stopping && !queue.empty() && queuedTexts < config.maxBatchSize) {
+                Clock::time_point deadline = queue.front().submitted + config.maxWait;
+                if (Clock::now() >= deadline) {
+                    break;
+                }
+                cv.wait_until(lock, deadline);
+            }
+            if (queue.empty()) {
+                continue; // taken by another model
+            }
+            batch = takeBatch(dropped);
+            backlog = queuedTexts;
+        }
+
+        for (auto& [request, status] : dropped) {
+            request.promise.set_exception(std::make_exception_ptr(RequestDropped(status)));
+        }
+        if (batch.empty()) {
+            continue; // every request taken had expired
+        }
+
+        std::vector<std::string> texts;
+        bool sameEntities = true;
+        size_t words = 0;
+        for (auto& request : batch) {
+            words = std::max(words, request.words);
+            sameEntities = sameEntities && request.entities == batch.front().entities;
+            texts.insert(texts.end(), request.texts.begin(), request.texts.end());
+        }
+
+        Clock::time_point start = Clock::now();
+        Result results;
+        std::exception_ptr error;
+        try {
+            const Request& head = batch.front();
+            if (sameEntities) {
+                results = model.inference(texts, head.entities, head.flatNer, head.threshold, head.multiLabel);
+            } else {
+                std::vector<std::vector<std::string>> entities;
+                entities.reserve(texts.size());
+                for (const auto& request : batch) {
+                    entities.insert(entities.end(), request.texts.size(), request.entities);
+                }
+                results = model.inferencePerRow(texts, entities, head.flatNer, head.threshold, head.multiLabel);
+            }
+            if (results.size() != texts.size()) {
+                throw std::runtime_error("Unexpected number of results");
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+        double runMillis = millisSince(start);
+
+        // Metrics are recorded before the results are released, so callers see them up to date.
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            counters.batches++;
+            counters.texts += texts.size();
+            counters.batchSizes.record(double(texts.size()));
+            counters.runMillis.record(runMillis);
+            std::vector<double> requestMillis;
+            requestMillis.reserve(batch.size());
+            for (const auto& request : batch) {
+                requestMillis.push_back(millisSince(request.submitted));
+                counters.requestMillis.record(requestMillis.back());
+            }
+            if (autotuner && !error && autotuner->observe(texts.size(), words, runMillis, requestMillis, backlog)) {
+                config = autotuner->current();
+            }
+        }
+
+        size_t offset = 0;
+        for (auto& request : batch) {
+            size_t n = request.texts.size();
+            if (error) {
+                request.promise.set_exception(error);
+            } else {
+                request.promise.set_value(Result(
+                    std::make_move_iterator(results.begin() + offset), std::make_move_iterator(results.begin() + offset + n)
+                ));
+            }
+            offset += n;
+        }
+    }
+}
+
+BatcherMetrics DynamicBatcher::metrics() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    BatcherMetrics out = counters;
+    out.queueDepth = queuedTexts;
+    out.queueRequests = queue.size();
+    out.limits = config;
+    if (autotuner) {
+        out.autotuneDecisions = autotuner->state().decisions;
+        out.autotuneP99Millis = autotuner->state().windowP99Millis;
+    }
+    return out;
+}
+
+BatcherConfig DynamicBatcher::getConfig() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return config;
+}
+
+void DynamicBatcher::setConfig(const BatcherConfig& config) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->config = config;
+        this->config.maxBatchSize = std::max<size_t>(1, config.maxBatchSize);
+        if (autotuner) {
+            autotuner = std::make_unique<BatchAutotuner>(autotuner->settings(), this->config);
+            this->config = autotuner->current();
+        }
+    }
+    cv.notify_all();
+}
+
+void DynamicBatcher::enableAutotune(const AutotuneConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex);
+    autotuner = std::make_unique<BatchAutotuner>(config, this->config);
+    this->config = autotuner->current();
+}
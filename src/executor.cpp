@@ -0,0 +1,57 @@
+#include "GLiNER/executor.hpp"
+
+using namespace gliner;
+
+Executor::Executor(size_t numWorkers) {
+    if (numWorkers == 0) {
+        numWorkers = 1;
+    }
+    workers.reserve(numWorkers);
+    for (size_t i = 0; i < numWorkers; ++i) {
+        workers.emplace_back(&Executor::workerLoop, this);
+    }
+}
+
+Executor::~Executor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void Executor::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return; // stopping and nothing left to run
+            }
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
+
+void Executor::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push(std::move(task));
+    }
+    cv.notify_one();
+}
+
+size_t Executor::size() const {
+    return workers.size();
+}
+
+size_t Executor::queued() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return tasks.size();
+}
@@ -0,0 +1,174 @@
+#include <deque>
+#include <limits>
+#include <stdexcept>
+
+#include "GLiNER/gazetteer.hpp"
+#include "GLiNER/tokenizer_utils.hpp"
+
+using namespace gliner;
+
+namespace {
+    const uint32_t UNKNOWN_WORD = std::numeric_limits<uint32_t>::max();
+
+    uint64_t edgeKey(uint32_t node, uint32_t word) {
+        return uint64_t(node) << 32 | word;
+    }
+
+    void foldCase(std::string_view word, std::string& folded) {
+        folded.assign(word);
+        for (char& c : folded) {
+            if (c >= 'A' && c <= 'Z') {
+                c = char(c - 'A' + 'a');
+            }
+        }
+    }
+}
+
+Gazetteer::Gazetteer(const std::vector<GazetteerLabel>& labels, bool caseSensitive)
+    : nodes(1), caseSensitive(caseSensitive) {
+    if (labels.size() >= std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("Too many gazetteer labels");
+    }
+    WhitespaceTokenSplitter splitter;
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> children(1); // (word, child) per node, for the fail links
+    std::string folded;
+
+    for (size_t l = 0; l < labels.size(); ++l) {
+        names.push_back(labels[l].label);
+        scores.push_back(labels[l].score);
+        closedLabels.push_back(labels[l].closed);
+        for (const auto& phrase : labels[l].phrases) {
+            uint32_t node = 0;
+            for (const auto& token : splitter.call(phrase)) {
+                if (caseSensitive) {
+                    folded = token.text;
+                } else {
+                    foldCase(token.text, folded);
+                }
+                uint32_t word = vocabulary.emplace(folded, uint32_t(vocabulary.size())).first->second;
+                auto edge = edges.emplace(edgeKey(node, word), uint32_t(nodes.size()));
+                if (edge.second) {
+                    children[node].push_back({word, edge.first->second});
+                    nodes.emplace_back();
+                    nodes.back().depth = nodes[node].depth + 1;
+                    children.emplace_back();
+                }
+                node = edge.first->second;
+            }
+            auto& ending = nodes[node].labels;
+            if (node != 0 && (ending.empty() || ending.back() != l)) {
+                ending.push_back(uint32_t(l));
+            }
+        }
+    }
+
+    // Fail links in breadth-first order, so the links of shallower nodes are final when used.
+    std::deque<uint32_t> queue;
+    for (const auto& [word, next] : children[0]) {
+        queue.push_back(next);
+    }
+    while (!queue.empty()) {
+        uint32_t node = queue.front();
+        queue.pop_front();
+        for (const auto& [word, next] : children[node]) {
+            uint32_t fail = nodes[node].fail;
+            uint32_t target = child(fail, word);
+            while (target == 0 && fail != 0) {
+                fail = nodes[fail].fail;
+                target = child(fail, word);
+            }
+            nodes[next].fail = target;
+            nodes[next].output = nodes[target].labels.empty() ? nodes[target].output : target;
+            queue.push_back(next);
+        }
+    }
+}
+
+uint32_t Gazetteer::wordId(std::string_view word, std::string& folded) const {
+    if (caseSensitive) {
+        folded.assign(word);
+    } else {
+        foldCase(word, folded);
+    }
+    auto it = vocabulary.find(folded);
+    return it == vocabulary.end() ? UNKNOWN_WORD : it->second;
+}
+
+uint32_t Gazetteer::child(uint32_t node, uint32_t word) const {
+    auto it = edges.find(edgeKey(node, word));
+    return it == edges.end() ? 0 : it->second; // the root is nobody's child
+}
+
+size_t Gazetteer::numLabels() const {
+    return names.size();
+}
+
+const std::string& Gazetteer::label(size_t id) const {
+    return names.at(id);
+}
+
+float Gazetteer::score(size_t id) const {
+    return scores.at(id);
+}
+
+bool Gazetteer::closed(size_t id) const {
+    return closedLabels.at(id);
+}
+
+int Gazetteer::labelId(const std::string& label) const {
+    for (size_t l = 0; l < names.size(); ++l) {
+        if (names[l] == label) {
+            return int(l);
+        }
+    }
+    return -1;
+}
+
+GazetteerPlan Gazetteer::plan(const std::vector<std::string>& entities) const {
+    GazetteerPlan plan;
+    plan.entityOf.assign(names.size(), -1);
+    std::vector<std::string> dropped;
+    for (const auto& entity : entities) {
+        int id = labelId(entity);
+        if (id < 0) {
+            plan.prompt.push_back(entity);
+            continue;
+        }
+        plan.matches = true;
+        if (closedLabels[id]) {
+            dropped.push_back(entity);
+        } else {
+            plan.entityOf[id] = int(plan.prompt.size());
+            plan.prompt.push_back(entity);
+        }
+    }
+    plan.labels = plan.prompt;
+    for (const auto& entity : dropped) {
+        plan.entityOf[labelId(entity)] = int(plan.labels.size());
+        plan.labels.push_back(entity);
+    }
+    return plan;
+}
+
+void Gazetteer::match(std::string_view text, const std::vector<Token>& words, std::vector<GazetteerMatch>& out) const {
+    std::string folded;
+    uint32_t state = 0;
+    for (size_t w = 0; w < words.size(); ++w) {
+        uint32_t word = wordId(text.substr(words[w].start, words[w].end - words[w].start), folded);
+        if (word == UNKNOWN_WORD) {
+            state = 0; // no phrase contains this word
+            continue;
+        }
+        uint32_t next = child(state, word);
+        while (next == 0 && state != 0) {
+            state = nodes[state].fail;
+            next = child(state, word);
+        }
+        state = next;
+        for (uint32_t node = nodes[state].labels.empty() ? nodes[state].output : state; node != 0; node = nodes[node].output) {
+            for (uint32_t label : nodes[node].labels) {
+                out.push_back({w + 1 - nodes[node].depth, w, label});
+            }
+        }
+    }
+}
@@ -0,0 +1,169 @@
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <stdexcept>
+
+#include "GLiNER/inference_result.hpp"
+
+using namespace gliner;
+
+namespace {
+    const char MAGIC[4] = {'G', 'L', 'R', 'S'};
+    const uint32_t VERSION = 1;
+
+    template <typename T>
+    void write(std::ofstream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void writeString(std::ofstream& out, const std::string& s) {
+        write<uint64_t>(out, s.size());
+        out.write(s.data(), s.size());
+    }
+
+    template <typename T>
+    T read(std::ifstream& in) {
+        T value;
+        if (!in.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+            throw std::runtime_error("Unexpected end of inference result file");
+        }
+        return value;
+    }
+
+    // Reads an element count and checks that that many elements of elementBytes fit in the
+    // rest of the file, so a corrupt count fails before anything is allocated for it.
+    uint64_t readCount(std::ifstream& in, uint64_t fileSize, uint64_t elementBytes) {
+        uint64_t count = read<uint64_t>(in);
+        if (count > (fileSize - uint64_t(in.tellg())) / elementBytes) {
+            throw std::runtime_error("Corrupt inference result file: count exceeds the file size");
+        }
+        return count;
+    }
+
+    std::string readString(std::ifstream& in, uint64_t fileSize) {
+        std::string s(readCount(in, fileSize, 1), '\0');
+        if (!in.read(&s[0], s.size())) {
+            throw std::runtime_error("Unexpected end of inference result file");
+        }
+        return s;
+    }
+
+    // Product of dims, or limit + 1 as soon as it exceeds limit.
+    uint64_t boundedProduct(std::initializer_list<uint64_t> dims, uint64_t limit) {
+        for (uint64_t dim : dims) {
+            if (dim == 0) {
+                return 0;
+            }
+        }
+        uint64_t product = 1;
+        for (uint64_t dim : dims) {
+            if (product > limit / dim) {
+                return limit + 1;
+            }
+            product *= dim;
+        }
+        return product;
+    }
+}
+
+void InferenceResult::save(const std::string& path) const {
+    if (batchTokens.size() != texts.size()) {
+        throw std::invalid_argument("Expected one word list per text in the inference result");
+    }
+    std::ofstream out(path, std::ios::out | std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+
+    out.write(MAGIC, sizeof(MAGIC));
+    write(out, VERSION);
+    write<uint8_t>(out, modelType);
+    write(out, numWords);
+    write(out, width);
+
+    write<uint64_t>(out, entities.size());
+    for (const auto& ent : entities) {
+        writeString(out, ent);
+    }
+
+    write<uint64_t>(out, texts.size());
+    for (size_t i = 0; i < texts.size(); ++i) {
+        writeString(out, texts[i]);
+        write<uint64_t>(out, batchTokens[i].size());
+        for (const auto& token : batchTokens[i]) {
+            write<uint64_t>(out, token.start);
+            write<uint64_t>(out, token.end);
+        }
+    }
+
+    write<uint64_t>(out, logits.size());
+    out.write(reinterpret_cast<const char*>(logits.data()), logits.size() * sizeof(float));
+    if (!out) {
+        throw std::runtime_error("Failed to write file: " + path);
+    }
+}
+
+InferenceResult InferenceResult::load(const std::string& path) {
+    std::ifstream in(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!in) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    uint64_t fileSize = uint64_t(in.tellg());
+    in.seekg(0);
+
+    char magic[sizeof(MAGIC)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not an inference result file: " + path);
+    }
+    if (read<uint32_t>(in) != VERSION) {
+        throw std::runtime_error("Unsupported inference result version: " + path);
+    }
+
+    InferenceResult result;
+    uint8_t modelType = read<uint8_t>(in);
+    if (modelType != TOKEN_LEVEL && modelType != SPAN_LEVEL) {
+        throw std::runtime_error("Corrupt inference result file: unknown model type");
+    }
+    result.modelType = static_cast<ModelType>(modelType);
+    result.numWords = read<int64_t>(in);
+    result.width = read<int64_t>(in);
+    if (result.numWords < 0 || result.width < 0) {
+        throw std::runtime_error("Corrupt inference result file: negative dimensions");
+    }
+
+    result.entities.resize(readCount(in, fileSize, sizeof(uint64_t)));
+    for (auto& ent : result.entities) {
+        ent = readString(in, fileSize);
+    }
+
+    size_t batchSize = readCount(in, fileSize, 2 * sizeof(uint64_t));
+    result.texts.resize(batchSize);
+    result.batchTokens.resize(batchSize);
+    for (size_t i = 0; i < batchSize; ++i) {
+        const std::string& text = result.texts[i] = readString(in, fileSize);
+        auto& tokens = result.batchTokens[i];
+        tokens.resize(readCount(in, fileSize, 2 * sizeof(uint64_t)));
+        for (auto& token : tokens) {
+            token.start = read<uint64_t>(in);
+            token.end = read<uint64_t>(in);
+            if (token.start > token.end || token.end > text.size()) {
+                throw std::runtime_error("Corrupt inference result file: token offsets outside the text");
+            }
+            token.text = text.substr(token.start, token.end - token.start);
+        }
+    }
+
+    uint64_t numLogits = readCount(in, fileSize, sizeof(float));
+    // [batch, word, width, entity] for span-level models, [start/end/inside, batch, word, entity] for token-level
+    uint64_t expected = result.modelType == SPAN_LEVEL
+        ? boundedProduct({batchSize, uint64_t(result.numWords), uint64_t(result.width), result.entities.size()}, numLogits)
+        : boundedProduct({3, batchSize, uint64_t(result.numWords), result.entities.size()}, numLogits);
+    if (numLogits != expected) {
+        throw std::runtime_error("Corrupt inference result file: logits do not match the batch shape");
+    }
+    result.logits.resize(numLogits);
+    if (!in.read(reinterpret_cast<char*>(result.logits.data()), result.logits.size() * sizeof(float))) {
+        throw std::runtime_error("Unexpected end of inference result file");
+    }
+    return result;
+}
@@ -0,0 +1,86 @@
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "GLiNER/mapped_file.hpp"
+
+using namespace gliner;
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    fileHandle = file;
+    length = static_cast<size_t>(fileSize.QuadPart);
+    if (length == 0) {
+        return; // empty files cannot be mapped
+    }
+
+    HANDLE view = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (view == nullptr) {
+        CloseHandle(file);
+        throw std::runtime_error("Cannot map file: " + path);
+    }
+    mappingHandle = view;
+    mapping = static_cast<const char*>(MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0));
+    if (mapping == nullptr) {
+        CloseHandle(view);
+        CloseHandle(file);
+        throw std::runtime_error("Cannot map file: " + path);
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (mapping != nullptr) {
+        UnmapViewOfFile(mapping);
+    }
+    if (mappingHandle != nullptr) {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle != nullptr) {
+        CloseHandle(fileHandle);
+    }
+}
+#else
+MappedFile::MappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot stat file: " + path);
+    }
+    length = static_cast<size_t>(st.st_size);
+    if (length == 0) {
+        close(fd);
+        return; // empty files cannot be mapped
+    }
+
+    void* addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps its own reference to the file
+    if (addr == MAP_FAILED) {
+        throw std::runtime_error("Cannot map file: " + path);
+    }
+    madvise(addr, length, MADV_SEQUENTIAL);
+    mapping = static_cast<const char*>(addr);
+}
+
+MappedFile::~MappedFile() {
+    if (mapping != nullptr) {
+        munmap(const_cast<char*>(mapping), length);
+    }
+}
+#endif
@@ -1,4 +1,10 @@
+#include <chrono>
+#include <cmath>
 #include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 
 #include "GLiNER/model.hpp"
 
@@ -10,7 +16,8 @@ Model::Model(
 {
     env = new Ort::Env(ORT_LOGGING_LEVEL_WARNING, "gliner");
     sessionOptions = new Ort::SessionOptions();
-    session = new Ort::Session(*env, modelPath.data(), *sessionOptions);
+    configureMemory(env, *sessionOptions);
+    createSession(*env, *sessionOptions);
     initialize(tokenizer_path);
 }
 
@@ -20,8 +27,9 @@ Model::Model(
 {
     env = new Ort::Env(ORT_LOGGING_LEVEL_WARNING, "gliner");
     sessionOptions = new Ort::SessionOptions();
+    configureMemory(env, *sessionOptions);
     useDevice(sessionOptions, device_id);
-    session = new Ort::Session(*env, modelPath.data(), *sessionOptions);
+    createSession(*env, *sessionOptions);
     initialize(tokenizer_path);
 }
 
@@ -29,11 +37,17 @@ Model::Model(
     const std::string& path, const std::string& tokenizer_path, const Config& config, const Ort::Env& env, const Ort::SessionOptions& session_options
 ) : modelPath(path), config(config)
 {
-    session = new Ort::Session(env, modelPath.data(), session_options);
+    Ort::SessionOptions options = session_options.Clone();
+    configureMemory(nullptr, options);
+    createSession(env, options);
     initialize(tokenizer_path);
 }
 
 Model::~Model() {
+    waitIdle();
+    executor.reset();
+    watchdog.reset();
+
     if (env != nullptr) {
         delete env;
     }
@@ -66,6 +80,59 @@ void Model::initialize(const std::string& tokenizer_path) {
         outputNames = {"logits"};
         break;
     }
+    if (!config.warmupShapes.empty()) {
+        warmupTimings = warmup(config.warmupShapes);
+    }
+}
+
+bool WarmupTiming::stable(double tolerance) const {
+    if (millis.size() < 2) {
+        return false;
+    }
+    double last = millis[millis.size() - 1];
+    double previous = millis[millis.size() - 2];
+    return std::abs(last - previous) <= tolerance * std::max(last, previous);
+}
+
+std::vector<WarmupTiming> Model::warmup(const std::vector<WarmupShape>& shapes) {
+    static const char* words[] = {
+        "The", "committee", "met", "in", "Geneva", "on", "Monday", "to", "discuss", "new", "trade", "rules"
+    };
+    constexpr size_t numWords = sizeof(words) / sizeof(words[0]);
+
+    std::vector<WarmupTiming> timings;
+    timings.reserve(shapes.size());
+    for (const auto& shape : shapes) {
+        std::string text;
+        for (size_t i = 0; i < std::max<size_t>(1, shape.numTokens); ++i) {
+            if (i > 0) {
+                text += ' ';
+            }
+            text += words[i % numWords];
+        }
+        std::vector<std::string> texts(std::max<size_t>(1, shape.batchSize), text);
+        // One word per label, so the prompt has numLabels words besides the markers.
+        std::vector<std::string> entities;
+        for (size_t l = 0; l < std::max<size_t>(1, shape.numLabels); ++l) {
+            entities.push_back("label" + std::to_string(l));
+        }
+
+        std::vector<std::vector<Span>> scratch;
+        WarmupTiming timing{shape, {}};
+        for (size_t r = 0; r < std::max<size_t>(1, shape.repeats); ++r) {
+            auto start = std::chrono::steady_clock::now();
+            compute(texts, entities, true, 0.5, false, nullptr, scratch); // bypasses the result cache
+            timing.millis.push_back(
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+            );
+        }
+        timings.push_back(std::move(timing));
+    }
+    return timings;
+}
+
+const std::vector<WarmupTiming>& Model::warmupReport() const {
+    return warmupTimings;
 }
 
 void Model::useDevice(Ort::SessionOptions* session_options, const int device_id) {
@@ -76,6 +143,31 @@ void Model::useDevice(Ort::SessionOptions* session_options, const int device_id)
     }
 }
 
+Batch* Model::prepareBatch(const std::vector<std::string>& texts, const std::vector<std::string>& entities) {
+    std::lock_guard<std::mutex> lock(processorMutex);
+    return processor->prepareBatch(texts, entities);
+}
+
+Batch* Model::prepareBatch(const std::vector<std::string>& texts, const std::vector<std::vector<std::string>>& entities) {
+    std::lock_guard<std::mutex> lock(processorMutex);
+    return processor->prepareBatch(texts, entities);
+}
+
+Batch* Model::prepareBatch(
+    const std::vector<std::string>& texts, const std::vector<PretokenizedText>& words, const std::vector<std::string>& entities
+) {
+    std::lock_guard<std::mutex> lock(processorMutex);
+    return processor->prepareBatch(texts, words, entities);
+}
+
+Batch* Model::prepareBatch(
+    std::vector<std::vector<Token>> words, const std::vector<std::vector<SubwordIds>>& textIds,
+    const std::vector<std::string>& entities
+) {
+    std::lock_guard<std::mutex> lock(processorMutex);
+    return processor->prepareBatch(std::move(words), textIds, entities);
+}
+
 int64_t Model::count_total_elements(std::vector<int64_t>& output_shape) {
     int64_t total_elements = 1;
     for (int64_t i : output_shape) {
@@ -85,12 +177,131 @@ int64_t Model::count_total_elements(std::vector<int64_t>& output_shape) {
 }
 
 void Model::run(const std::vector<Ort::Value>& input_tensors, std::vector<float>& output) {
+    Ort::RunOptions run_options;
+    run(input_tensors, output, run_options);
+}
+
+void Model::run(
+    const std::vector<Ort::Value>& input_tensors, std::vector<float>& output, Ort::RunOptions& run_options, RunStats* stats
+) {
+    RunStats call;
+    call.inputBytes = tensorBytes(input_tensors);
+    call.arenaShrunk = configureRun(run_options, call.inputBytes);
     std::vector<Ort::Value> modelOutputs = session->Run(
-        Ort::RunOptions(), inputNames.data(), 
+        run_options, inputNames.data(), 
         input_tensors.data(), inputNames.size(), 
         outputNames.data(), outputNames.size()
     );
-    Ort::Value& output_tensor = modelOutputs[0];
+    copyOutput(modelOutputs[0], output);
+    call.outputBytes = output.size() * sizeof(float);
+    recordCall(call);
+    if (stats != nullptr) {
+        *stats = call;
+    }
+}
+
+void Model::configureMemory(Ort::Env* env, Ort::SessionOptions& session_options) {
+    const MemoryConfig& memory = config.memory;
+    if (!memory.memPattern) {
+        session_options.DisableMemPattern();
+    }
+    if (!memory.cpuArena) {
+        session_options.DisableCpuMemArena();
+        return;
+    }
+    if (memory.maxArenaBytes == 0 && memory.arenaExtendStrategy == DEFAULT_EXTEND) {
+        return;
+    }
+    if (env == nullptr) {
+        // The arena limits live in an allocator registered on the Env, which belongs to the caller here.
+        std::cerr << "WARNING! Arena limits are ignored for a shared Ort::Env; register the allocator on it instead." << std::endl;
+        return;
+    }
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    Ort::ArenaCfg arena_cfg(memory.maxArenaBytes, memory.arenaExtendStrategy, -1, -1);
+    env->CreateAndRegisterAllocator(memory_info, arena_cfg);
+    session_options.AddConfigEntry("session.use_env_allocators", "1");
+}
+
+void Model::createSession(const Ort::Env& env, Ort::SessionOptions& session_options) {
+    const LoadConfig& load = config.load;
+    modelFormat = load.format == AUTO_FORMAT ? detectModelFormat(modelPath) : load.format;
+    if (load.int8Qdq) {
+        session_options.AddConfigEntry("session.qdqisint8allowed", "1");
+    }
+    if (modelFormat != ORT_FORMAT) {
+        session = new Ort::Session(env, modelPath.data(), session_options);
+        return;
+    }
+    session_options.AddConfigEntry("session.load_model_format", "ORT");
+    if (!load.mapOrtModel) {
+        session = new Ort::Session(env, modelPath.data(), session_options);
+        return;
+    }
+    // The session keeps pointers into the mapping for its initializers, so it lives as long as the Model.
+    modelBytes = std::make_unique<MappedFile>(modelPath);
+    session_options.AddConfigEntry("session.use_ort_model_bytes_directly", "1");
+    session_options.AddConfigEntry("session.use_ort_model_bytes_for_initializers", "1");
+    session = new Ort::Session(env, modelBytes->data(), modelBytes->size(), session_options);
+}
+
+size_t Model::tensorBytes(const std::vector<Ort::Value>& tensors) {
+    size_t bytes = 0;
+    for (const auto& tensor : tensors) {
+        Ort::TensorTypeAndShapeInfo info = tensor.GetTensorTypeAndShapeInfo();
+        size_t elementSize;
+        switch (info.GetElementType()) {
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+            elementSize = 1;
+            break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+            elementSize = 8;
+            break;
+        default:
+            elementSize = 4;
+            break;
+        }
+        bytes += info.GetElementCount() * elementSize;
+    }
+    return bytes;
+}
+
+bool Model::configureRun(Ort::RunOptions& run_options, size_t inputBytes) {
+    size_t limit = config.memory.shrinkAboveBytes;
+    if (limit == 0 || inputBytes < limit) {
+        return false;
+    }
+    // Returns the arena chunks this oversized run allocated once it completes.
+    run_options.AddConfigEntry("memory.enable_memory_arena_shrinkage", "cpu:0");
+    return true;
+}
+
+void Model::recordCall(const RunStats& stats) {
+    auto raise = [](std::atomic<size_t>& peak, size_t bytes) {
+        size_t current = peak.load();
+        while (bytes > current && !peak.compare_exchange_weak(current, bytes)) {
+        }
+    };
+    raise(peakInputBytes, stats.inputBytes);
+    raise(peakOutputBytes, stats.outputBytes);
+    if (stats.arenaShrunk) {
+        arenaShrinks++;
+    }
+}
+
+ModelFormat Model::format() const {
+    return modelFormat;
+}
+
+MemoryStats Model::memoryStats() const {
+    return {peakInputBytes.load(), peakOutputBytes.load(), arenaShrinks.load()};
+}
+
+void Model::copyOutput(const Ort::Value& output_tensor, std::vector<float>& output) {
     Ort::TensorTypeAndShapeInfo output_info = output_tensor.GetTensorTypeAndShapeInfo();
     std::vector<int64_t> output_shape = output_info.GetShape();
 
@@ -98,27 +309,561 @@ void Model::run(const std::vector<Ort::Value>& input_tensors, std::vector<float>
     output = std::vector<float>(output_data, output_data + count_total_elements(output_shape));
 }
 
+void Model::setCache(std::shared_ptr<ResultCache> result_cache, const std::string& model_id) {
+    cache = std::move(result_cache);
+    cacheModelId = model_id.empty() ? modelPath : model_id;
+}
+
+void Model::setGazetteer(std::shared_ptr<const Gazetteer> dictionary) {
+    gazetteer = std::move(dictionary);
+}
+
 std::vector<std::vector<Span>> Model::inference(
     const std::vector<std::string>& texts, const std::vector<std::string>& entities, bool flatNer, float threshold, bool multiLabel
 ) {
+    std::vector<std::vector<Span>> results;
+    process(texts, entities, flatNer, threshold, multiLabel, nullptr, results);
+    return results;
+}
+
+InferenceStatus Model::inference(
+    const std::vector<std::string>& texts, const std::vector<std::string>& entities,
+    const RequestControl& control, std::vector<std::vector<Span>>& output,
+    bool flatNer, float threshold, bool multiLabel
+) {
+    return process(texts, entities, flatNer, threshold, multiLabel, &control, output);
+}
+
+InferenceStatus Model::process(
+    const std::vector<std::string>& texts, const std::vector<std::string>& entities,
+    bool flatNer, float threshold, bool multiLabel,
+    const RequestControl* control, std::vector<std::vector<Span>>& results
+) {
+    results.clear();
+    if (control != nullptr) {
+        InferenceStatus status = control->check();
+        if (status != InferenceStatus::OK) {
+            return status; // expired before any work was done
+        }
+    }
     if (!checkInputs(texts, entities)) {
         std::cerr << "WARNING! Empty texts or entities." << std::endl;
-        return {};
+        return InferenceStatus::OK;
     }
 
-    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-    std::vector<float> output;
+    results.resize(texts.size());
+    std::vector<size_t> duplicateOf(texts.size(), texts.size());
+    std::vector<size_t> missIds;
+    std::vector<CacheKey> keys;
+    std::unordered_map<std::string_view, size_t> firstSeen;
+    firstSeen.reserve(texts.size());
+
+    CacheKey params{};
+    if (cache) {
+        params = ResultCache::paramsKey(entities, threshold, flatNer, multiLabel, cacheModelId);
+        keys.resize(texts.size());
+    }
+
+    // Repeated texts are computed once; cached texts are not computed at all.
+    for (size_t i = 0; i < texts.size(); ++i) {
+        auto seen = firstSeen.emplace(texts[i], i);
+        if (!seen.second) {
+            duplicateOf[i] = seen.first->second;
+            continue;
+        }
+        if (cache) {
+            keys[i] = ResultCache::textKey(texts[i], params);
+            if (cache->get(keys[i], texts[i], results[i])) {
+                continue;
+            }
+        }
+        missIds.push_back(i);
+    }
+
+    InferenceStatus status = InferenceStatus::OK;
+    if (missIds.size() == texts.size()) {
+        status = compute(texts, entities, flatNer, threshold, multiLabel, control, results);
+    } else if (!missIds.empty()) {
+        std::vector<std::string> missTexts;
+        missTexts.reserve(missIds.size());
+        for (size_t id : missIds) {
+            missTexts.push_back(texts[id]);
+        }
+        std::vector<std::vector<Span>> computed;
+        status = compute(missTexts, entities, flatNer, threshold, multiLabel, control, computed);
+        for (size_t k = 0; k < computed.size(); ++k) {
+            results[missIds[k]] = std::move(computed[k]);
+        }
+    }
+    if (status != InferenceStatus::OK) {
+        results.clear();
+        return status;
+    }
+
+    if (cache) {
+        for (size_t id : missIds) {
+            cache->put(keys[id], texts[id], results[id]);
+        }
+    }
+    for (size_t i = 0; i < texts.size(); ++i) {
+        if (duplicateOf[i] < texts.size()) {
+            results[i] = results[duplicateOf[i]];
+        }
+    }
+    return InferenceStatus::OK;
+}
+
+InferenceStatus Model::compute(
+    const std::vector<std::string>& texts, const std::vector<std::string>& entities,
+    bool flatNer, float threshold, bool multiLabel,
+    const RequestControl* control, std::vector<std::vector<Span>>& output
+) {
+    GazetteerPlan plan;
+    if (gazetteer) {
+        plan = gazetteer->plan(entities);
+    }
+    const std::vector<std::string>& prompt = plan.matches ? plan.prompt : entities;
+
+    std::vector<float> logits;
+    std::unique_ptr<Batch> batch;
+    if (!prompt.empty()) {
+        batch.reset(prepareBatch(texts, prompt));
+        InferenceStatus status = runBatch(*batch, logits, control);
+        if (status != InferenceStatus::OK) {
+            return status;
+        }
+    }
+
+    if (!plan.matches) {
+        output = decoder->decode(
+            batch.get(), texts, entities, logits, flatNer, threshold, multiLabel
+        );
+        return InferenceStatus::OK;
+    }
+
+    std::vector<std::vector<Token>> words;
+    if (!batch) { // closed labels only: split the words without building a batch
+        std::lock_guard<std::mutex> lock(processorMutex);
+        words = processor->batchTokenizeText(texts);
+    }
+    auto matches = gazetteerCandidates(texts, batch ? batch->batchTokens : words, plan, threshold);
+    output = decoder->decodeMerged(
+        batch.get(), texts, plan.labels, plan.prompt.size(), logits, matches, flatNer, threshold, multiLabel
+    );
+    return InferenceStatus::OK;
+}
+
+std::vector<std::vector<SpanCandidate>> Model::gazetteerCandidates(
+    const std::vector<std::string>& texts, const std::vector<std::vector<Token>>& words,
+    const GazetteerPlan& plan, float threshold
+) const {
+    std::vector<std::vector<SpanCandidate>> candidates(texts.size());
+    std::vector<GazetteerMatch> found;
+    for (size_t b = 0; b < texts.size(); ++b) {
+        found.clear();
+        gazetteer->match(texts[b], words[b], found);
+        for (const auto& match : found) {
+            int entity = plan.entityOf[match.label];
+            float score = gazetteer->score(match.label);
+            if (entity < 0 || score < threshold) {
+                continue;
+            }
+            candidates[b].push_back({int(words[b][match.startWord].start), int(words[b][match.endWord].end), entity, score});
+        }
+    }
+    return candidates;
+}
+
+namespace {
+    // Registers a session run with the request's cancellation token and the deadline watchdog.
+    class RunRegistration {
+    private:
+        Ort::RunOptions* runOptions;
+        CancellationToken token;
+        Watchdog* watchdog;
+    public:
+        RunRegistration(Ort::RunOptions* run_options, const RequestControl& control, Watchdog* watchdog)
+            : runOptions(run_options), token(control.cancellation), watchdog(watchdog) {
+            token.attach(runOptions);
+            if (watchdog != nullptr) {
+                watchdog->watch(control.deadline, runOptions);
+            }
+        }
+        ~RunRegistration() {
+            if (watchdog != nullptr) {
+                watchdog->unwatch(runOptions);
+            }
+            token.detach(runOptions);
+        }
+    };
+}
+
+InferenceStatus Model::runControlled(
+    const std::vector<Ort::Value>& input_tensors, std::vector<float>& output, const RequestControl& control,
+    RunStats* stats
+) {
+    InferenceStatus status = control.check();
+    if (status != InferenceStatus::OK) {
+        return status;
+    }
 
-    // std::vector<Prompt> prompts; // TODO: delete
-    Batch* batch = processor->prepareBatch(texts, entities);
+    Ort::RunOptions run_options;
+    {
+        Watchdog* dog = control.deadline == Clock::time_point::max() ? nullptr : &getWatchdog();
+        RunRegistration registration(&run_options, control, dog);
+        try {
+            run(input_tensors, output, run_options, stats);
+        } catch (const Ort::Exception&) {
+            status = control.check();
+            if (status == InferenceStatus::OK) {
+                throw; // a genuine failure, not a termination we requested
+            }
+            return status;
+        }
+    }
+    return control.check(); // nobody will read a result that arrived too late
+}
 
+InferenceStatus Model::runBatch(Batch& batch, std::vector<float>& logits, const RequestControl* control, RunStats* stats) {
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
     std::vector<Ort::Value> input_tensors;
-    batch->tensors(input_tensors, memory_info);
-    run(input_tensors, output);
+    batch.tensors(input_tensors, memory_info);
+    if (control != nullptr) {
+        return runControlled(input_tensors, logits, *control, stats);
+    }
+    Ort::RunOptions run_options;
+    run(input_tensors, logits, run_options, stats);
+    return InferenceStatus::OK;
+}
+
+Watchdog& Model::getWatchdog() {
+    std::call_once(watchdogFlag, [this] {
+        watchdog = std::make_unique<Watchdog>();
+    });
+    return *watchdog;
+}
+
+void Model::inferenceColumns(
+    const std::vector<std::string>& texts, const std::vector<std::string>& entities, ColumnarSpans& output,
+    bool flatNer, float threshold, bool multiLabel
+) {
+    output.clear();
+    if (!checkInputs(texts, entities)) {
+        std::cerr << "WARNING! Empty texts or entities." << std::endl;
+        return;
+    }
+
+    std::vector<float> logits;
+    std::unique_ptr<Batch> batch(prepareBatch(texts, entities));
+    runBatch(*batch, logits);
+
+    decoder->decodeColumns(
+        batch->batchTokens, batch->numWords, batch->width(), entities, logits, output, flatNer, threshold, multiLabel
+    );
+}
+
+std::vector<std::vector<Span>> Model::inference(
+    const std::vector<std::string>& texts, const std::vector<PretokenizedText>& words,
+    const std::vector<std::string>& entities, bool flatNer, float threshold, bool multiLabel
+) {
+    if (!checkInputs(texts, entities)) {
+        std::cerr << "WARNING! Empty texts or entities." << std::endl;
+        return {};
+    }
+
+    std::vector<float> logits;
+    std::unique_ptr<Batch> batch(prepareBatch(texts, words, entities));
+    runBatch(*batch, logits);
+
+    return decoder->decode(batch.get(), texts, entities, logits, flatNer, threshold, multiLabel);
+}
+
+std::vector<std::vector<Span>> Model::inference(
+    const TokenShard& shard, size_t begin, size_t end, const std::vector<std::string>& entities,
+    bool flatNer, float threshold, bool multiLabel
+) {
+    if (begin > end || end > shard.size()) {
+        throw std::out_of_range("Document range out of range of the token shard");
+    }
+    if (shard.tokenizerFingerprint() != processor->tokenizerFingerprint()) {
+        throw std::invalid_argument("Token shard was written with a different tokenizer");
+    }
+    std::vector<std::string> texts;
+    std::vector<std::vector<Token>> words;
+    std::vector<std::vector<SubwordIds>> textIds;
+    for (size_t doc = begin; doc < end; ++doc) {
+        texts.emplace_back(shard.text(doc));
+        words.push_back(shard.words(doc));
+        textIds.push_back(shard.subwordIds(doc));
+    }
+    if (!checkInputs(texts, entities)) {
+        std::cerr << "WARNING! Empty texts or entities." << std::endl;
+        return {};
+    }
+
+    std::vector<float> logits;
+    std::unique_ptr<Batch> batch(prepareBatch(std::move(words), textIds, entities));
+    runBatch(*batch, logits);
+
+    return decoder->decode(batch.get(), texts, entities, logits, flatNer, threshold, multiLabel);
+}
+
+std::vector<std::vector<Span>> Model::inferencePerRow(
+    const std::vector<std::string>& texts, const std::vector<std::vector<std::string>>& entities,
+    bool flatNer, float threshold, bool multiLabel
+) {
+    if (texts.size() != entities.size()) {
+        throw std::invalid_argument("Expected one label list per text");
+    }
+    bool empty = texts.empty();
+    for (const auto& labels : entities) {
+        empty = empty || labels.empty();
+    }
+    if (empty) {
+        std::cerr << "WARNING! Empty texts or entities." << std::endl;
+        return {};
+    }
+
+    std::vector<float> logits;
+    std::unique_ptr<Batch> batch(prepareBatch(texts, entities));
+    runBatch(*batch, logits);
+
+    return decoder->decode(batch.get(), texts, entities, logits, flatNer, threshold, multiLabel);
+}
+
+InferenceResult Model::forward(const std::vector<std::string>& texts, const std::vector<std::string>& entities) {
+    InferenceResult result{config.modelType, 0, 0, texts, entities, {}, {}, {}};
+    if (!checkInputs(texts, entities)) {
+        std::cerr << "WARNING! Empty texts or entities." << std::endl;
+        result.batchTokens.resize(texts.size()); // one (empty) word list per text, as save() expects
+        return result;
+    }
+
+    std::unique_ptr<Batch> batch(prepareBatch(texts, entities));
+    runBatch(*batch, result.logits, nullptr, &result.runStats);
+
+    result.numWords = batch->numWords;
+    result.width = batch->width();
+    result.batchTokens = std::move(batch->batchTokens);
+    return result;
+}
+
+std::vector<std::vector<Span>> Model::decode(
+    const InferenceResult& result, bool flatNer, float threshold, bool multiLabel
+) {
+    if (result.texts.empty() || result.entities.empty()) {
+        return {};
+    }
+    if (result.modelType != config.modelType) {
+        throw std::invalid_argument("Inference result was produced by a model of another type");
+    }
+    return decoder->decode(result, flatNer, threshold, multiLabel);
+}
+
+Executor& Model::getExecutor() {
+    std::call_once(executorFlag, [this] {
+        executor = std::make_unique<Executor>(config.numWorkers);
+    });
+    return *executor;
+}
+
+namespace {
+    // Callbacks run on executor or ORT threads, where an escaping exception would terminate the process.
+    template <typename Callback, typename... Args>
+    void deliver(Callback& callback, Args&&... args) {
+        try {
+            callback(std::forward<Args>(args)...);
+        } catch (const std::exception& e) {
+            std::cerr << "WARNING! Inference callback threw: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "WARNING! Inference callback threw." << std::endl;
+        }
+    }
+}
+
+void Model::beginRequest() {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    ++pending;
+}
+
+void Model::endRequest() {
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        --pending;
+    }
+    pendingCv.notify_all();
+}
 
-    auto decoded = decoder->decode(
-        batch, texts, entities, output, flatNer, threshold, multiLabel
+void Model::waitIdle() {
+    std::unique_lock<std::mutex> lock(pendingMutex);
+    pendingCv.wait(lock, [this] { return pending == 0; });
+}
+
+std::future<std::vector<std::vector<Span>>> Model::inferenceAsync(
+    std::vector<std::string> texts, std::vector<std::string> entities, bool flatNer, float threshold, bool multiLabel
+) {
+    auto promise = std::make_shared<std::promise<std::vector<std::vector<Span>>>>();
+    auto future = promise->get_future();
+    inferenceAsync(
+        std::move(texts), std::move(entities),
+        [promise](std::vector<std::vector<Span>>&& result, std::exception_ptr error) {
+            if (error) {
+                promise->set_exception(error);
+            } else {
+                promise->set_value(std::move(result));
+            }
+        },
+        flatNer, threshold, multiLabel
     );
-    delete batch;
-    return decoded;
+    return future;
+}
+
+void Model::inferenceAsync(
+    std::vector<std::string> texts, std::vector<std::string> entities, InferenceCallback callback,
+    bool flatNer, float threshold, bool multiLabel
+) {
+    beginRequest();
+    PendingRequest pending(this);
+    getExecutor().submit([this, texts = std::move(texts), entities = std::move(entities),
+                          callback = std::move(callback), flatNer, threshold, multiLabel]() mutable {
+        // Gazetteer matches are merged in compute(), so such models run the session here.
+        if (config.useRunAsync && !gazetteer) {
+            runAsync(std::move(texts), std::move(entities), std::move(callback), flatNer, threshold, multiLabel);
+            return;
+        }
+
+        PendingRequest pending(this);
+        std::vector<std::vector<Span>> result;
+        std::exception_ptr error;
+        try {
+            result = inference(texts, entities, flatNer, threshold, multiLabel);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        deliver(callback, std::move(result), error);
+    });
+    pending.release(); // the queued task ends it
+}
+
+void Model::inferenceAsync(
+    std::vector<std::string> texts, std::vector<std::string> entities, RequestControl control, StatusCallback callback,
+    bool flatNer, float threshold, bool multiLabel
+) {
+    beginRequest();
+    PendingRequest pending(this);
+    getExecutor().submit([this, texts = std::move(texts), entities = std::move(entities), control = std::move(control),
+                          callback = std::move(callback), flatNer, threshold, multiLabel]() mutable {
+        PendingRequest pending(this);
+        // Requests that expired while queued are shed here without touching the processor.
+        std::vector<std::vector<Span>> result;
+        InferenceStatus status = InferenceStatus::OK;
+        std::exception_ptr error;
+        try {
+            status = process(texts, entities, flatNer, threshold, multiLabel, &control, result);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        deliver(callback, status, std::move(result), error);
+    });
+    pending.release(); // the queued task ends it
+}
+
+struct Model::AsyncRun {
+    Model* model;
+    Batch* batch = nullptr;
+    std::vector<std::string> texts;
+    std::vector<std::string> entities;
+    std::vector<Ort::Value> inputs;
+    std::vector<Ort::Value> outputs;
+    bool flatNer;
+    float threshold;
+    bool multiLabel;
+    InferenceCallback callback;
+    Ort::RunOptions runOptions;
+    RunStats stats;
+
+    ~AsyncRun() {
+        delete batch;
+    }
+};
+
+void Model::onRunComplete(void* user_data, OrtValue** /*outputs*/, size_t /*num_outputs*/, OrtStatusPtr status_ptr) {
+    Model* model = static_cast<AsyncRun*>(user_data)->model;
+    PendingRequest pending(model); // declared first: the request ends after the run is freed
+    std::unique_ptr<AsyncRun> run(static_cast<AsyncRun*>(user_data));
+    Ort::Status status(status_ptr);
+
+    std::vector<std::vector<Span>> result;
+    std::exception_ptr error;
+    try {
+        if (!status.IsOK()) {
+            throw Ort::Exception(status.GetErrorMessage(), status.GetErrorCode());
+        }
+        std::vector<float> output;
+        copyOutput(run->outputs[0], output); // ORT fills the values we passed to RunAsync
+        run->stats.outputBytes = output.size() * sizeof(float);
+        model->recordCall(run->stats);
+        result = model->decoder->decode(
+            run->batch, run->texts, run->entities, output, run->flatNer, run->threshold, run->multiLabel
+        );
+    } catch (...) {
+        error = std::current_exception();
+    }
+    deliver(run->callback, std::move(result), error);
+}
+
+void Model::runAsync(
+    std::vector<std::string> texts, std::vector<std::string> entities, InferenceCallback callback,
+    bool flatNer, float threshold, bool multiLabel
+) {
+#if ORT_API_VERSION >= 16
+    PendingRequest pending(this); // declared first: the request ends after the run is freed
+    std::unique_ptr<AsyncRun> run(new AsyncRun{
+        this, nullptr, std::move(texts), std::move(entities), {}, {}, flatNer, threshold, multiLabel, std::move(callback), {}, {}
+    });
+    try {
+        if (!checkInputs(run->texts, run->entities)) {
+            std::cerr << "WARNING! Empty texts or entities." << std::endl;
+            deliver(run->callback, std::vector<std::vector<Span>>(), nullptr);
+            return;
+        }
+
+        Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        run->batch = prepareBatch(run->texts, run->entities);
+        run->batch->tensors(run->inputs, memory_info);
+        for (size_t i = 0; i < outputNames.size(); ++i) {
+            run->outputs.emplace_back(nullptr);
+        }
+        run->stats.inputBytes = tensorBytes(run->inputs);
+        run->stats.arenaShrunk = configureRun(run->runOptions, run->stats.inputBytes);
+
+        // From here the request is owned by onRunComplete, which runs on an ORT intra-op thread.
+        AsyncRun* submitted = run.release();
+        try {
+            session->RunAsync(
+                submitted->runOptions, inputNames.data(),
+                submitted->inputs.data(), inputNames.size(),
+                outputNames.data(), submitted->outputs.data(), outputNames.size(),
+                onRunComplete, submitted
+            );
+        } catch (...) {
+            run.reset(submitted);
+            throw;
+        }
+        pending.release(); // onRunComplete ends the request
+    } catch (...) {
+        deliver(run->callback, std::vector<std::vector<Span>>(), std::current_exception());
+    }
+#else
+    // RunAsync is unavailable in this ONNX Runtime; run the session on the executor thread instead.
+    PendingRequest pending(this);
+    std::vector<std::vector<Span>> result;
+    std::exception_ptr error;
+    try {
+        result = inference(texts, entities, flatNer, threshold, multiLabel);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    deliver(callback, std::move(result), error);
+#endif
 }
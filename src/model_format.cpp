@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+
+#include "GLiNER/mapped_file.hpp"
+#include "GLiNER/model_format.hpp"
+
+using namespace gliner;
+
+namespace {
+    // ORT format models are flatbuffers with this file identifier after the root offset.
+    const char ORT_IDENTIFIER[4] = {'O', 'R', 'T', 'M'};
+
+    // Operators left in the graph by dynamic (MatMulInteger), static QDQ, QOperator
+    // and weight-only (MatMulNBits) quantization, before and after ORT fusions.
+    const char* QUANTIZED_OPS[] = {
+        "DynamicQuantizeLinear", "QuantizeLinear", "DequantizeLinear", "MatMulInteger", "ConvInteger",
+        "DynamicQuantizeMatMul", "MatMulIntegerToFloat", "QLinearMatMul", "QLinearConv", "QAttention", "MatMulNBits"
+    };
+
+    // Whether `name` is stored as a whole string: ONNX protobufs prefix it with a
+    // one-byte varint length, ORT flatbuffers with a little-endian uint32 length.
+    bool containsString(std::string_view data, std::string_view name, ModelFormat format) {
+        size_t prefix = format == ORT_FORMAT ? 4 : 1;
+        std::boyer_moore_horspool_searcher searcher(name.begin(), name.end());
+        auto it = data.begin();
+        while ((it = std::search(it, data.end(), searcher)) != data.end()) {
+            size_t pos = it - data.begin();
+            if (pos >= prefix) {
+                const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data() + pos - prefix);
+                size_t length = format == ORT_FORMAT ? size_t(p[0]) | size_t(p[1]) << 8 | size_t(p[2]) << 16 | size_t(p[3]) << 24
+                                                     : size_t(p[0]);
+                if (length == name.size()) {
+                    return true;
+                }
+            }
+            ++it;
+        }
+        return false;
+    }
+}
+
+ModelFormat gliner::detectModelFormat(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    char head[8] = {};
+    in.read(head, sizeof(head));
+    if (in.gcount() == sizeof(head) && std::memcmp(head + 4, ORT_IDENTIFIER, sizeof(ORT_IDENTIFIER)) == 0) {
+        return ORT_FORMAT;
+    }
+    return ONNX_FORMAT;
+}
+
+ModelFileInfo gliner::inspectModelFile(const std::string& path) {
+    ModelFileInfo info;
+    info.format = detectModelFormat(path);
+    MappedFile file(path);
+    info.bytes = file.size();
+    for (const char* op : QUANTIZED_OPS) {
+        if (containsString(file.view(), op, info.format)) {
+            info.quantizedOps.push_back(op);
+        }
+    }
+    return info;
+}
+
+const char* gliner::formatName(ModelFormat format) {
+    switch (format) {
+    case ONNX_FORMAT:
+        return "onnx";
+    case ORT_FORMAT:
+        return "ort";
+    default:
+        return "auto";
+    }
+}
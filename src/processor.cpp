@@ -1,4 +1,7 @@
+#include <algorithm>
 #include <regex>
+#include <stdexcept>
+#include <unordered_map>
 
 #include "GLiNER/processor.hpp"
 
@@ -8,6 +11,11 @@ Processor::Processor(const Config& config, const std::string& tokenizer_path)
     : config(config), wordSplitter(WhitespaceTokenSplitter()) {
     const std::string blob = LoadBytesFromFile(tokenizer_path);
     tokenizer = tokenizers::Tokenizer::FromBlobJSON(blob);
+    fingerprint = TokenizerFingerprint(blob);
+}
+
+uint64_t Processor::tokenizerFingerprint() const {
+    return fingerprint;
 }
 
 std::vector<Token> Processor::tokenizeText(const std::string& text) {
@@ -25,68 +33,192 @@ std::vector<std::vector<Token>> Processor::batchTokenizeText(const std::vector<s
     return res;
 }
 
-void Processor::prepareTextInputs(
-    const std::vector<std::string>& entities,
-    Batch* output,
-    std::vector<Prompt>& prompts
+void Processor::appendEntitiesPrompt(
+    const std::vector<std::string>& entities, std::pmr::vector<std::string_view>& prompt
 ) {
-    std::vector<std::string> entities_prompt;
-    entities_prompt.reserve(entities.size()*2+1);
+    prompt.reserve(prompt.size() + entities.size()*2+1);
     for (const auto& ent : entities) {
-        entities_prompt.push_back("<<ENT>>");
-        entities_prompt.push_back(ent);
+        prompt.push_back("<<ENT>>");
+        prompt.push_back(ent);
     }
-    entities_prompt.push_back("<<SEP>>");
-    auto promptLength = entities_prompt.size();
+    prompt.push_back("<<SEP>>");
+}
 
-    output->textLengths = new int64_t[output->batchSize];
-    output->textLengthsShape = new int64_t[2]{output->batchSize, 1};
+void Processor::resetTextInputs(Batch* output) {
+    output->textLengths.assign(output->batchSize, 0);
+    output->textLengthsShape[0] = output->batchSize;
+    output->textLengthsShape[1] = 1;
     output->numWords = 0;
-    for (size_t i = 0; i < static_cast<size_t>(output->batchSize); ++i) {
-        const std::vector<Token>& currTokens = output->batchTokens[i];
-        std::vector<std::string> inputText;
-        inputText.reserve(currTokens.size() + promptLength);
-        inputText.insert(inputText.end(), entities_prompt.begin(), entities_prompt.end());
-        for (auto t : currTokens) {
-            inputText.push_back(t.text);
+}
+
+void Processor::setWords(std::vector<std::vector<Token>> words, Batch* output) {
+    output->batchSize = words.size();
+    output->batchTokens = std::move(words);
+}
+
+void Processor::attachTextIds(const std::vector<std::vector<SubwordIds>>& textIds, std::pmr::vector<Prompt>& prompts) {
+    if (textIds.empty()) {
+        return;
+    }
+    if (textIds.size() != prompts.size()) {
+        throw std::invalid_argument("Expected subword ids for every text");
+    }
+    for (size_t i = 0; i < prompts.size(); ++i) {
+        if (textIds[i].empty()) {
+            continue;
         }
+        if (textIds[i].size() != static_cast<size_t>(prompts[i].textLength)) {
+            throw std::invalid_argument("Expected subword ids for every word");
+        }
+        prompts[i].textIds = &textIds[i];
+    }
+}
 
-        output->textLengths[i] = int64_t(currTokens.size());
-        prompts.push_back({
-            int64_t(currTokens.size()),
-            int64_t(promptLength),
-            inputText,
-        });
-        output->numWords = std::max(prompts[i].textLength, output->numWords);
+Batch* Processor::prepareBatch(
+    const std::vector<std::string>& texts,
+    const std::vector<PretokenizedText>& words,
+    const std::vector<std::string>& entities
+) {
+    if (words.size() != texts.size()) {
+        throw std::invalid_argument("Expected one word list per text");
     }
+    std::vector<std::vector<Token>> tokens(texts.size());
+    std::vector<std::vector<SubwordIds>> textIds(texts.size());
+    for (size_t i = 0; i < texts.size(); ++i) {
+        const PretokenizedText& row = words[i];
+        bool encoded = !row.subwordIds.empty();
+        if (encoded && row.subwordIds.size() != row.words.size()) {
+            throw std::invalid_argument("Expected subword ids for every word");
+        }
+        tokens[i].reserve(row.words.size());
+        for (size_t k = 0; k < row.words.size(); ++k) {
+            const Token& word = row.words[k];
+            if (word.start > word.end || word.end > texts[i].size()) {
+                throw std::invalid_argument("Word offsets out of range of the text");
+            }
+            tokens[i].push_back(word);
+            if (word.text.empty() && !encoded) {
+                tokens[i].back().text = texts[i].substr(word.start, word.end - word.start);
+            }
+            if (encoded) {
+                textIds[i].push_back({row.subwordIds[k].data(), row.subwordIds[k].size()});
+            }
+        }
+    }
+    return prepareBatch(std::move(tokens), textIds, entities);
 }
 
-void Processor::encodeInputs(const std::vector<Prompt>& prompts, Batch* output) {    
-    std::vector<std::vector<std::vector<int>>> tmp;
-    tmp.reserve(prompts.size());
+void Processor::addPrompt(
+    size_t row,
+    const std::pmr::vector<std::string_view>& entities_prompt,
+    Batch* output,
+    std::pmr::vector<Prompt>& prompts
+) {
+    const std::vector<Token>& currTokens = output->batchTokens[row];
+    auto promptLength = entities_prompt.size();
+    std::pmr::vector<std::string_view> inputText(prompts.get_allocator().resource());
+    inputText.reserve(currTokens.size() + promptLength);
+    inputText.insert(inputText.end(), entities_prompt.begin(), entities_prompt.end());
+    for (const auto& t : currTokens) {
+        inputText.push_back(t.text);
+    }
+
+    output->textLengths[row] = int64_t(currTokens.size());
+    prompts.push_back({
+        int64_t(currTokens.size()),
+        int64_t(promptLength),
+        std::move(inputText),
+        nullptr,
+    });
+    output->numWords = std::max(prompts.back().textLength, output->numWords);
+}
+
+void Processor::prepareTextInputs(
+    const std::vector<std::string>& entities,
+    Batch* output,
+    std::pmr::vector<Prompt>& prompts
+) {
+    std::pmr::vector<std::string_view> entities_prompt(prompts.get_allocator().resource());
+    appendEntitiesPrompt(entities, entities_prompt);
+
+    resetTextInputs(output);
+    for (size_t i = 0; i < static_cast<size_t>(output->batchSize); ++i) {
+        addPrompt(i, entities_prompt, output, prompts);
+    }
+}
+
+void Processor::prepareTextInputs(
+    const std::vector<std::vector<std::string>>& entities,
+    Batch* output,
+    std::pmr::vector<Prompt>& prompts
+) {
+    if (entities.size() != static_cast<size_t>(output->batchSize)) {
+        throw std::invalid_argument("Expected one label list per text");
+    }
+    std::pmr::vector<std::string_view> entities_prompt(prompts.get_allocator().resource());
+
+    resetTextInputs(output);
+    for (size_t i = 0; i < static_cast<size_t>(output->batchSize); ++i) {
+        entities_prompt.clear();
+        appendEntitiesPrompt(entities[i], entities_prompt);
+        addPrompt(i, entities_prompt, output, prompts);
+    }
+}
+
+void Processor::encodeInputs(const std::pmr::vector<Prompt>& prompts, Batch* output) {
+    std::pmr::memory_resource* resource = prompts.get_allocator().resource();
+    // Distinct words of all prompts are encoded with a single tokenizer call, except
+    // text words whose ids were given; wordIds[w] points to the ids of word w of the
+    // flattened prompts and distinctIds[w] is its distinct word, or given.
+    const size_t given = size_t(-1);
+    std::pmr::unordered_map<std::string_view, size_t> distinct(resource);
+    std::pmr::vector<SubwordIds> wordIds(resource);
+    std::pmr::vector<size_t> distinctIds(resource);
+    std::vector<std::string> words;
 
-    output->numTokens = 0;
     for (const Prompt& p: prompts) {
-        std::vector<std::vector<int>> pt;
-        pt.reserve(p.prompt.size());
+        for (size_t tokenId = 0; tokenId < p.prompt.size(); ++tokenId) {
+            if (p.textIds != nullptr && tokenId >= static_cast<size_t>(p.promptLength)) {
+                wordIds.push_back((*p.textIds)[tokenId - p.promptLength]);
+                distinctIds.push_back(given);
+                continue;
+            }
+            auto inserted = distinct.emplace(p.prompt[tokenId], words.size());
+            if (inserted.second) {
+                words.emplace_back(p.prompt[tokenId]);
+            }
+            wordIds.push_back({nullptr, 0});
+            distinctIds.push_back(inserted.first->second);
+        }
+    }
+    std::vector<std::vector<int32_t>> encoded = words.empty()
+        ? std::vector<std::vector<int32_t>>()
+        : tokenizer->EncodeBatch(words);
+    for (size_t w = 0; w < wordIds.size(); ++w) {
+        if (distinctIds[w] != given) {
+            const std::vector<int32_t>& ids = encoded[distinctIds[w]];
+            wordIds[w] = {ids.data(), ids.size()};
+        }
+    }
 
-        
+    output->numTokens = 0;
+    for (size_t p = 0, w = 0; p < prompts.size(); p++) {
         int64_t s = 2; // padding tokens
-        for (const std::string& word : p.prompt) {
-            pt.push_back(tokenizer->Encode(word));
-            s += pt.back().size();
+        for (size_t end = w + prompts[p].prompt.size(); w < end; ++w) {
+            s += wordIds[w].size;
         }
-        tmp.push_back(pt);
         output->numTokens = std::max(output->numTokens, s);
     }
 
     output->inputsSize = output->numTokens*output->batchSize;
-    output->inputsShape = new int64_t[2]{output->batchSize, output->numTokens};
-    output->inputsIds = new int64_t[output->inputsSize]();
-    output->attentionMasks = new int64_t[output->inputsSize]();
-    output->wordsMasks = new int64_t[output->inputsSize]();
+    output->inputsShape[0] = output->batchSize;
+    output->inputsShape[1] = output->numTokens;
+    output->inputsIds.assign(output->inputsSize, 0);
+    output->attentionMasks.assign(output->inputsSize, 0);
+    output->wordsMasks.assign(output->inputsSize, 0);
 
-    for (size_t p = 0; p < tmp.size(); p++) {
+    size_t w = 0;
+    for (size_t p = 0; p < prompts.size(); p++) {
         int64_t promptLength = prompts[p].promptLength;
 
         size_t idx = p * output->numTokens;
@@ -94,19 +226,16 @@ void Processor::encodeInputs(const std::vector<Prompt>& prompts, Batch* output)
         output->attentionMasks[idx] = 1;
         idx++;
 
-        for (size_t tokenId = 0, wordId = 1; tokenId < tmp[p].size(); ++tokenId) {
-            const auto& word = tmp[p][tokenId];
-
+        for (size_t tokenId = 0, wordId = 1; tokenId < prompts[p].prompt.size(); ++tokenId, ++w) {
             if (tokenId >= static_cast<size_t>(promptLength)) {
                 output->wordsMasks[idx] = wordId;
                 wordId++;
             }
 
-            for (int t : word) {
-                output->inputsIds[idx] = t;
-                output->attentionMasks[idx] = 1;
-                idx++;
-            }
+            const SubwordIds& ids = wordIds[w];
+            std::copy(ids.data, ids.data + ids.size, output->inputsIds.begin() + idx);
+            std::fill_n(output->attentionMasks.begin() + idx, ids.size, 1);
+            idx += ids.size;
         }
         output->attentionMasks[idx] = 1;
         output->inputsIds[idx] = 2;
@@ -119,16 +248,19 @@ SpanProcessor::SpanProcessor(const Config& config, const std::string& tokenizer_
 // SpanProcessor::SpanProcessor(const Config& config, Tokenizer& tokenizer, const WhitespaceTokenSplitter& wordSplitter)
 //     : Processor(config, tokenizer, wordSplitter) {};
 
-void SpanProcessor::prepareSpans(const std::vector<Prompt>& prompts, SpanBatch* output) {
+void SpanProcessor::prepareSpans(const std::pmr::vector<Prompt>& prompts, SpanBatch* output) {
     output->numSpans = output->numWords*output->maxWidth;
 
     output->spanIdxsSize = output->batchSize*output->numSpans*2;
-    output->spanIdxs = new int64_t[output->spanIdxsSize]();
-    output->spanIdxsShape = new int64_t[3]{output->batchSize, output->numSpans, 2};
+    output->spanIdxs.assign(output->spanIdxsSize, 0);
+    output->spanIdxsShape[0] = output->batchSize;
+    output->spanIdxsShape[1] = output->numSpans;
+    output->spanIdxsShape[2] = 2;
 
     output->spanMasksSize = output->batchSize*output->numSpans;
-    output->spanMasks = new bool[output->spanMasksSize]();
-    output->spanMasksShape = new int64_t[2]{output->batchSize, output->numSpans};
+    output->spanMasks.assign(output->spanMasksSize, 0);
+    output->spanMasksShape[0] = output->batchSize;
+    output->spanMasksShape[1] = output->numSpans;
 
     for (size_t p = 0; p < prompts.size(); p++) {
         for (int64_t i = 0; i < prompts[p].textLength; i++) { 
@@ -143,39 +275,154 @@ void SpanProcessor::prepareSpans(const std::vector<Prompt>& prompts, SpanBatch*
     }
 }
 
+template <typename Labels>
+void SpanProcessor::fillBatch(
+    const Labels& entities,
+    SpanBatch& output,
+    const std::vector<std::vector<SubwordIds>>* textIds
+) {
+    output.maxWidth = config.maxWidth;
+
+    Arena& arena = Arena::local();
+    Arena::Scope scope(arena);
+    std::pmr::vector<Prompt> prompts(arena.resource());
+    prompts.reserve(output.batchSize);
+    prepareTextInputs(entities, &output, prompts);
+    if (textIds != nullptr) {
+        attachTextIds(*textIds, prompts);
+    }
+    encodeInputs(prompts, &output);
+    prepareSpans(prompts, &output);
+}
+
 Batch* SpanProcessor::prepareBatch(
     const std::vector<std::string>& texts,
     const std::vector<std::string>& entities
 ) {
     SpanBatch* output = new SpanBatch;
-    output->maxWidth = config.maxWidth;
-    output->batchSize = texts.size();
+    prepareBatch(texts, entities, *output);
+    return output;
+}
 
-    output->batchTokens = batchTokenizeText(texts);
+Batch* SpanProcessor::prepareBatch(
+    const std::vector<std::string>& texts,
+    const std::vector<std::vector<std::string>>& entities
+) {
+    SpanBatch* output = new SpanBatch;
+    prepareBatch(texts, entities, *output);
+    return output;
+}
 
-    std::vector<Prompt> prompts;
-    prompts.reserve(output->batchSize);
-    prepareTextInputs(entities, output, prompts);
-    encodeInputs(prompts, output);
-    prepareSpans(prompts, output);
+void SpanProcessor::prepareBatch(
+    const std::vector<std::string>& texts,
+    const std::vector<std::string>& entities,
+    SpanBatch& output
+) {
+    setWords(batchTokenizeText(texts), &output);
+    fillBatch(entities, output, nullptr);
+}
+
+void SpanProcessor::prepareBatch(
+    const std::vector<std::string>& texts,
+    const std::vector<std::vector<std::string>>& entities,
+    SpanBatch& output
+) {
+    setWords(batchTokenizeText(texts), &output);
+    fillBatch(entities, output, nullptr);
+}
+
+Batch* SpanProcessor::prepareBatch(
+    std::vector<std::vector<Token>> words,
+    const std::vector<std::vector<SubwordIds>>& textIds,
+    const std::vector<std::string>& entities
+) {
+    SpanBatch* output = new SpanBatch;
+    prepareBatch(std::move(words), textIds, entities, *output);
     return output;
 }
 
+void SpanProcessor::prepareBatch(
+    std::vector<std::vector<Token>> words,
+    const std::vector<std::vector<SubwordIds>>& textIds,
+    const std::vector<std::string>& entities,
+    SpanBatch& output
+) {
+    setWords(std::move(words), &output);
+    fillBatch(entities, output, &textIds);
+}
+
 TokenProcessor::TokenProcessor(const Config& config, const std::string& tokenizer_path)
     : Processor(config, tokenizer_path) {};
 
+template <typename Labels>
+void TokenProcessor::fillBatch(
+    const Labels& entities,
+    TokenBatch& output,
+    const std::vector<std::vector<SubwordIds>>* textIds
+) {
+    Arena& arena = Arena::local();
+    Arena::Scope scope(arena);
+    std::pmr::vector<Prompt> prompts(arena.resource());
+    prompts.reserve(output.batchSize);
+    prepareTextInputs(entities, &output, prompts);
+    if (textIds != nullptr) {
+        attachTextIds(*textIds, prompts);
+    }
+    encodeInputs(prompts, &output);
+}
+
 Batch* TokenProcessor::prepareBatch(
     const std::vector<std::string>& texts,
     const std::vector<std::string>& entities
 ) {
     TokenBatch* output = new TokenBatch;
-    output->batchSize = texts.size();
+    prepareBatch(texts, entities, *output);
+    return output;
+}
+
+Batch* TokenProcessor::prepareBatch(
+    const std::vector<std::string>& texts,
+    const std::vector<std::vector<std::string>>& entities
+) {
+    TokenBatch* output = new TokenBatch;
+    prepareBatch(texts, entities, *output);
+    return output;
+}
+
+void TokenProcessor::prepareBatch(
+    const std::vector<std::string>& texts,
+    const std::vector<std::string>& entities,
+    TokenBatch& output
+) {
+    setWords(batchTokenizeText(texts), &output);
+    fillBatch(entities, output, nullptr);
+}
 
-    output->batchTokens = batchTokenizeText(texts);
+void TokenProcessor::prepareBatch(
+    const std::vector<std::string>& texts,
+    const std::vector<std::vector<std::string>>& entities,
+    TokenBatch& output
+) {
+    setWords(batchTokenizeText(texts), &output);
+    fillBatch(entities, output, nullptr);
+}
 
-    std::vector<Prompt> prompts;
-    prompts.reserve(output->batchSize);
-    prepareTextInputs(entities, output, prompts);
-    encodeInputs(prompts, output);
+Batch* TokenProcessor::prepareBatch(
+    std::vector<std::vector<Token>> words,
+    const std::vector<std::vector<SubwordIds>>& textIds,
+    const std::vector<std::string>& entities
+) {
+    TokenBatch* output = new TokenBatch;
+    prepareBatch(std::move(words), textIds, entities, *output);
     return output;
-}
\ No newline at end of file
+}
+
+void TokenProcessor::prepareBatch(
+    std::vector<std::vector<Token>> words,
+    const std::vector<std::vector<SubwordIds>>& textIds,
+    const std::vector<std::string>& entities,
+    TokenBatch& output
+) {
+    setWords(std::move(words), &output);
+    fillBatch(entities, output, &textIds);
+}
@@ -0,0 +1,78 @@
+#include "GLiNER/reloadable_model.hpp"
+
+using namespace gliner;
+
+ReloadableModel::ReloadableModel(const std::string& model_path, const std::string& tokenizer_path, const Config& config)
+    : config(config) {
+    current = publish(build(model_path, tokenizer_path), currentReleased);
+}
+
+ReloadableModel::ReloadableModel(
+    const std::string& model_path, const std::string& tokenizer_path, const Config& config,
+    const Ort::Env& env, const Ort::SessionOptions& session_options
+) : config(config), env(&env), sessionOptions(&session_options) {
+    current = publish(build(model_path, tokenizer_path), currentReleased);
+}
+
+ReloadableModel::~ReloadableModel() = default; // the reloader is destroyed first and drains its queue
+
+std::unique_ptr<Model> ReloadableModel::build(const std::string& model_path, const std::string& tokenizer_path) const {
+    std::unique_ptr<Model> model;
+    if (env != nullptr) {
+        model = std::make_unique<Model>(model_path, tokenizer_path, config, *env, *sessionOptions);
+    } else {
+        model = std::make_unique<Model>(model_path, tokenizer_path, config);
+    }
+    // The instance must not take traffic cold; the constructor already warmed it if config asks for shapes.
+    if (config.warmupShapes.empty()) {
+        model->warmup({{1, 16, 1, 1}});
+    }
+    return model;
+}
+
+std::shared_ptr<Model> ReloadableModel::publish(std::unique_ptr<Model> model, Released& released) {
+    auto owner = std::make_shared<std::promise<std::unique_ptr<Model>>>();
+    released = owner->get_future();
+    // The last holder passes ownership on instead of destroying the instance on its own thread.
+    return std::shared_ptr<Model>(model.release(), [owner](Model* last) {
+        owner->set_value(std::unique_ptr<Model>(last));
+    });
+}
+
+std::shared_ptr<Model> ReloadableModel::acquire() const {
+    return std::atomic_load(&current);
+}
+
+std::vector<std::vector<Span>> ReloadableModel::inference(
+    const std::vector<std::string>& texts, const std::vector<std::string>& entities, bool flatNer, float threshold, bool multiLabel
+) {
+    std::shared_ptr<Model> model = acquire();
+    return model->inference(texts, entities, flatNer, threshold, multiLabel);
+}
+
+std::future<void> ReloadableModel::reload(const std::string& model_path, const std::string& tokenizer_path) {
+    auto done = std::make_shared<std::promise<void>>();
+    std::future<void> future = done->get_future();
+    reloader.submit([this, done, model_path, tokenizer_path] {
+        Released retired;
+        try {
+            std::shared_ptr<Model> fresh = publish(build(model_path, tokenizer_path), retired);
+            std::atomic_store(&current, std::move(fresh));
+            std::swap(retired, currentReleased);
+            currentVersion++;
+        } catch (...) {
+            done->set_exception(std::current_exception());
+            return;
+        }
+        done->set_value();
+
+        // Blocks until calls still running on the old instance let go of it, so that it is
+        // never torn down on a request thread.
+        retired.get().reset();
+    });
+    return future;
+}
+
+uint64_t ReloadableModel::version() const {
+    return currentVersion.load();
+}
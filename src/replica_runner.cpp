@@ -0,0 +1,318 @@
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <dirent.h>
+#endif
+
+#include "GLiNER/replica_runner.hpp"
+
+using namespace gliner;
+
+namespace {
+    // Parses a sysfs cpulist such as "0-15,32-47".
+    std::vector<int> parseCpuList(const std::string& list) {
+        std::vector<int> cpus;
+        size_t pos = 0;
+        while (pos < list.size()) {
+            size_t end = list.find(',', pos);
+            if (end == std::string::npos) {
+                end = list.size();
+            }
+            std::string item = list.substr(pos, end - pos);
+            size_t dash = item.find('-');
+            try {
+                if (dash == std::string::npos) {
+                    cpus.push_back(std::stoi(item));
+                } else {
+                    int first = std::stoi(item.substr(0, dash));
+                    int last = std::stoi(item.substr(dash + 1));
+                    for (int cpu = first; cpu <= last; ++cpu) {
+                        cpus.push_back(cpu);
+                    }
+                }
+            } catch (const std::exception&) {
+                // trailing newline or malformed item
+            }
+            pos = end + 1;
+        }
+        return cpus;
+    }
+
+    std::vector<int> availableCpus() {
+        std::vector<int> cpus;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set)) {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+#endif
+        if (cpus.empty()) {
+            int count = std::max(1, int(std::thread::hardware_concurrency()));
+            for (int cpu = 0; cpu < count; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+
+    void pinCurrentThread(int cpu) {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)cpu;
+#endif
+    }
+}
+
+std::vector<std::vector<int>> ReplicaRunner::numaNodes() {
+    std::vector<int> available = availableCpus();
+    std::vector<std::vector<int>> nodes;
+#ifdef __linux__
+    if (DIR* dir = opendir("/sys/devices/system/node")) {
+        std::vector<int> ids;
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+                std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+                ids.push_back(std::stoi(name.substr(4)));
+            }
+        }
+        closedir(dir);
+        std::sort(ids.begin(), ids.end());
+
+        for (int id : ids) {
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+            std::string list;
+            std::getline(file, list);
+            std::vector<int> cpus;
+            for (int cpu : parseCpuList(list)) {
+                if (std::find(available.begin(), available.end(), cpu) != available.end()) {
+                    cpus.push_back(cpu);
+                }
+            }
+            if (!cpus.empty()) {
+                nodes.push_back(std::move(cpus));
+            }
+        }
+    }
+#endif
+    if (nodes.empty()) {
+        nodes.push_back(std::move(available));
+    }
+    return nodes;
+}
+
+std::vector<std::vector<int>> ReplicaRunner::partitionCores(size_t numReplicas, int threadsPerReplica, bool numaLocal) {
+    numReplicas = std::max<size_t>(1, numReplicas);
+    std::vector<std::vector<int>> groups = numaLocal ? numaNodes() : std::vector<std::vector<int>>{availableCpus()};
+
+    // Replicas are dealt round-robin over the groups, then each group is split evenly.
+    std::vector<size_t> perGroup(groups.size(), 0);
+    for (size_t r = 0; r < numReplicas; ++r) {
+        perGroup[r % groups.size()]++;
+    }
+
+    std::vector<std::vector<int>> sets(numReplicas);
+    for (size_t g = 0; g < groups.size(); ++g) {
+        const std::vector<int>& cpus = groups[g];
+        size_t count = perGroup[g];
+        for (size_t k = 0; k < count; ++k) {
+            std::vector<int>& set = sets[k * groups.size() + g];
+            size_t begin = k * cpus.size() / count;
+            size_t end = (k + 1) * cpus.size() / count;
+            if (begin == end) {
+                end = begin + 1; // more replicas than cores: share them
+            }
+            for (size_t i = begin; i < end; ++i) {
+                set.push_back(cpus[i % cpus.size()]);
+            }
+            if (threadsPerReplica > 0 && set.size() > size_t(threadsPerReplica)) {
+                set.resize(threadsPerReplica);
+            }
+        }
+    }
+    return sets;
+}
+
+std::string ReplicaRunner::affinityEntry(const std::vector<int>& cores) {
+    std::string entry;
+    for (size_t i = 1; i < cores.size(); ++i) {
+        if (!entry.empty()) {
+            entry += ';';
+        }
+        entry += std::to_string(cores[i] + 1);
+    }
+    return entry;
+}
+
+ReplicaRunner::ReplicaRunner(
+    const std::string& model_path, const std::string& tokenizer_path, const Config& config, const ReplicaConfig& replicaConfig
+) : env(ORT_LOGGING_LEVEL_WARNING, "gliner") {
+    std::vector<std::vector<int>> sets = partitionCores(
+        replicaConfig.numReplicas, replicaConfig.threadsPerReplica, replicaConfig.numaLocal
+    );
+    std::vector<std::vector<int>> nodes = replicaConfig.numaLocal ? numaNodes() : std::vector<std::vector<int>>{};
+
+    std::vector<std::promise<void>> ready(sets.size());
+    for (size_t r = 0; r < sets.size(); ++r) {
+        auto replica = std::make_unique<Replica>();
+        replica->cores = std::move(sets[r]);
+        for (size_t n = 0; n < nodes.size(); ++n) {
+            if (std::find(nodes[n].begin(), nodes[n].end(), replica->cores[0]) != nodes[n].end()) {
+                replica->numaNode = int(n);
+            }
+        }
+        replicas.push_back(std::move(replica));
+    }
+
+    // Sessions are built on their pinned threads, so first-touch allocations land on the local node.
+    for (size_t r = 0; r < replicas.size(); ++r) {
+        Replica* replica = replicas[r].get();
+        std::promise<void>* signal = &ready[r];
+        replica->thread = std::thread([this, replica, signal, &model_path, &tokenizer_path, &config, &replicaConfig] {
+            start(*replica, model_path, tokenizer_path, config, replicaConfig.pinThreads, *signal);
+        });
+    }
+
+    try {
+        for (auto& signal : ready) {
+            signal.get_future().get();
+        }
+    } catch (...) {
+        stop();
+        throw;
+    }
+}
+
+ReplicaRunner::~ReplicaRunner() {
+    stop();
+}
+
+void ReplicaRunner::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (auto& replica : replicas) {
+        if (replica->thread.joinable()) {
+            replica->thread.join();
+        }
+    }
+}
+
+void ReplicaRunner::start(
+    Replica& replica, const std::string& model_path, const std::string& tokenizer_path,
+    const Config& config, bool pinThreads, std::promise<void>& ready
+) {
+    try {
+        Ort::SessionOptions sessionOptions;
+        sessionOptions.SetIntraOpNumThreads(int(replica.cores.size()));
+        sessionOptions.SetInterOpNumThreads(1);
+        sessionOptions.SetGraphOptimizationLevel(ORT_ENABLE_ALL);
+        if (pinThreads) {
+            pinCurrentThread(replica.cores[0]);
+            std::string affinities = affinityEntry(replica.cores);
+            if (!affinities.empty()) {
+                sessionOptions.AddConfigEntry("session.intra_op_thread_affinities", affinities.c_str());
+            }
+        }
+        replica.model = std::make_unique<Model>(model_path, tokenizer_path, config, env, sessionOptions);
+    } catch (...) {
+        ready.set_exception(std::current_exception());
+        return;
+    }
+    ready.set_value();
+    loop(replica);
+}
+
+void ReplicaRunner::loop(Replica& replica) {
+    while (true) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this, &replica] { return stopping || !replica.own.empty() || !queue.empty(); });
+            std::deque<Request>& source = replica.own.empty() ? queue : replica.own;
+            if (source.empty()) {
+                return; // stopping and nothing left to run
+            }
+            request = std::move(source.front());
+            source.pop_front();
+        }
+        try {
+            request.promise.set_value(replica.model->inference(
+                request.texts, request.entities, request.flatNer, request.threshold, request.multiLabel
+            ));
+        } catch (...) {
+            request.promise.set_exception(std::current_exception());
+        }
+        replica.batches++;
+        replica.texts += request.texts.size();
+    }
+}
+
+std::future<std::vector<std::vector<Span>>> ReplicaRunner::submit(
+    std::vector<std::string> texts, std::vector<std::string> entities, bool flatNer, float threshold, bool multiLabel
+) {
+    Request request{std::move(texts), std::move(entities), flatNer, threshold, multiLabel, {}};
+    auto future = request.promise.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) {
+            throw std::runtime_error("ReplicaRunner is stopped");
+        }
+        queue.push_back(std::move(request));
+    }
+    cv.notify_one();
+    return future;
+}
+
+std::vector<std::vector<Span>> ReplicaRunner::inference(
+    const std::vector<std::string>& texts, const std::vector<std::string>& entities, bool flatNer, float threshold, bool multiLabel
+) {
+    return submit(texts, entities, flatNer, threshold, multiLabel).get();
+}
+
+void ReplicaRunner::warmup(const std::vector<std::string>& texts, const std::vector<std::string>& entities) {
+    std::vector<std::future<std::vector<std::vector<Span>>>> results;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) {
+            throw std::runtime_error("ReplicaRunner is stopped");
+        }
+        for (auto& replica : replicas) {
+            Request request{texts, entities, true, 0.5, false, {}};
+            results.push_back(request.promise.get_future());
+            replica->own.push_back(std::move(request));
+        }
+    }
+    cv.notify_all(); // the condition variable is shared, so wake every replica to find its own request
+    for (auto& result : results) {
+        result.get();
+    }
+}
+
+size_t ReplicaRunner::size() const {
+    return replicas.size();
+}
+
+std::vector<ReplicaStats> ReplicaRunner::stats() const {
+    std::vector<ReplicaStats> out;
+    out.reserve(replicas.size());
+    for (const auto& replica : replicas) {
+        out.push_back({replica->cores, replica->numaNode, replica->batches.load(), replica->texts.load()});
+    }
+    return out;
+}
@@ -0,0 +1,149 @@
+#include <cstring>
+
+#include "GLiNER/result_cache.hpp"
+
+using namespace gliner;
+
+namespace {
+    uint64_t rotl(uint64_t x, int r) {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    uint64_t fmix(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // Two independent lanes over the same 8-byte words; the length is folded into the
+    // tail so that concatenated fields cannot collide with each other.
+    void hashBytes(CacheKey& key, const char* data, size_t size) {
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t w;
+            std::memcpy(&w, data + i, 8);
+            key.hi = (key.hi ^ w) * 0xff51afd7ed558ccdULL;
+            key.hi ^= key.hi >> 32;
+            key.lo = rotl(key.lo ^ w, 29) * 0x9E3779B97F4A7C15ULL;
+        }
+        uint64_t tail = 0;
+        std::memcpy(&tail, data + i, size - i);
+        tail ^= uint64_t(size) << 56 | uint64_t(size) << 3;
+        key.hi = fmix(key.hi ^ tail);
+        key.lo = fmix(key.lo + tail * 0x9E3779B97F4A7C15ULL);
+    }
+
+    template <typename T>
+    void hashValue(CacheKey& key, const T& value) {
+        hashBytes(key, reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+}
+
+ResultCache::ResultCache(size_t maxBytes, size_t numShards) {
+    if (numShards == 0) {
+        numShards = 1;
+    }
+    shardCapacity = maxBytes / numShards;
+    shards.reserve(numShards);
+    for (size_t i = 0; i < numShards; ++i) {
+        shards.push_back(std::make_unique<Shard>());
+    }
+}
+
+CacheKey ResultCache::paramsKey(
+    const std::vector<std::string>& entities, float threshold, bool flatNer, bool multiLabel, const std::string& modelId
+) {
+    CacheKey key{0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL};
+    hashBytes(key, modelId.data(), modelId.size());
+    for (const auto& ent : entities) {
+        hashBytes(key, ent.data(), ent.size());
+    }
+    hashValue(key, threshold);
+    uint8_t flags = (flatNer ? 1 : 0) | (multiLabel ? 2 : 0);
+    hashValue(key, flags);
+    return key;
+}
+
+CacheKey ResultCache::textKey(std::string_view text, const CacheKey& params) {
+    CacheKey key = params;
+    hashBytes(key, text.data(), text.size());
+    return key;
+}
+
+ResultCache::Shard& ResultCache::shardFor(const CacheKey& key) {
+    return *shards[key.hi % shards.size()];
+}
+
+size_t ResultCache::entryBytes(std::string_view text, const std::vector<Span>& spans) {
+    size_t bytes = sizeof(Entry) + 4 * sizeof(void*) + text.size(); // list node and index slot
+    for (const auto& span : spans) {
+        bytes += sizeof(Span) + span.text.capacity() + span.classLabel.capacity();
+    }
+    return bytes;
+}
+
+bool ResultCache::get(const CacheKey& key, std::string_view text, std::vector<Span>& spans) {
+    Shard& shard = shardFor(key);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end() && it->second->text == text) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            spans = it->second->spans;
+            hits++;
+            return true;
+        }
+    }
+    misses++;
+    return false;
+}
+
+void ResultCache::put(const CacheKey& key, std::string_view text, const std::vector<Span>& spans) {
+    size_t bytes = entryBytes(text, spans);
+    if (bytes > shardCapacity) {
+        return; // would evict the whole shard
+    }
+
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return; // another thread stored the same result first, or a colliding text holds the key
+    }
+
+    while (!shard.lru.empty() && shard.bytes + bytes > shardCapacity) {
+        const Entry& victim = shard.lru.back();
+        shard.bytes -= victim.bytes;
+        shard.index.erase(victim.key);
+        shard.lru.pop_back();
+        evictions++;
+    }
+
+    shard.lru.push_front({key, std::string(text), spans, bytes});
+    shard.index.emplace(key, shard.lru.begin());
+    shard.bytes += bytes;
+    insertions++;
+}
+
+void ResultCache::clear() {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->lru.clear();
+        shard->index.clear();
+        shard->bytes = 0;
+    }
+}
+
+CacheStats ResultCache::stats() {
+    CacheStats out{hits.load(), misses.load(), insertions.load(), evictions.load(), 0, 0};
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        out.entries += shard->index.size();
+        out.bytes += shard->bytes;
+    }
+    return out;
+}
@@ -0,0 +1,225 @@
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "GLiNER/token_shard.hpp"
+
+using namespace gliner;
+
+namespace {
+    const char MAGIC[4] = {'G', 'L', 'T', 'S'};
+    const uint32_t VERSION = 2;
+    const size_t HEADER_BYTES = sizeof(MAGIC) + sizeof(VERSION) + sizeof(uint64_t);
+    const size_t TRAILER_BYTES = sizeof(uint64_t) + sizeof(MAGIC);
+
+    size_t align4(size_t n) {
+        return (n + 3) & ~size_t(3);
+    }
+}
+
+TokenShardWriter::TokenShardWriter(const std::string& path, const std::string& tokenizer_path)
+    : out(path, std::ios::out | std::ios::binary), path(path) {
+    if (!out) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    const std::string blob = LoadBytesFromFile(tokenizer_path);
+    tokenizer = tokenizers::Tokenizer::FromBlobJSON(blob);
+    uint64_t fingerprint = TokenizerFingerprint(blob);
+    write(MAGIC, sizeof(MAGIC));
+    write(&VERSION, sizeof(VERSION));
+    write(&fingerprint, sizeof(fingerprint));
+}
+
+TokenShardWriter::~TokenShardWriter() {
+    try {
+        finish();
+    } catch (...) {
+        // errors are only reported by an explicit finish()
+    }
+}
+
+void TokenShardWriter::write(const void* data, size_t size) {
+    out.write(static_cast<const char*>(data), size);
+    position += size;
+}
+
+void TokenShardWriter::pad(size_t alignment) {
+    static const char zeros[8] = {};
+    write(zeros, (alignment - position % alignment) % alignment);
+}
+
+void TokenShardWriter::add(const std::string& text) {
+    if (finished) {
+        throw std::runtime_error("Token shard is already finished: " + path);
+    }
+    if (text.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("Text is too long for a token shard");
+    }
+
+    std::vector<Token> words = wordSplitter.call(text);
+    std::vector<std::string> wordTexts;
+    wordTexts.reserve(words.size());
+    for (const auto& word : words) {
+        wordTexts.push_back(word.text);
+    }
+    std::vector<std::vector<int32_t>> encoded = wordTexts.empty()
+        ? std::vector<std::vector<int32_t>>()
+        : tokenizer->EncodeBatch(wordTexts);
+
+    std::vector<uint32_t> column(words.size());
+    uint32_t numIds = 0;
+    for (const auto& ids : encoded) {
+        numIds += ids.size();
+    }
+
+    pad(8);
+    offsets.push_back(position);
+    uint32_t header[4] = {uint32_t(words.size()), numIds, uint32_t(text.size()), 0};
+    write(header, sizeof(header));
+    write(text.data(), text.size());
+    pad(4);
+    for (size_t w = 0; w < words.size(); ++w) {
+        column[w] = words[w].start;
+    }
+    write(column.data(), column.size() * sizeof(uint32_t));
+    for (size_t w = 0; w < words.size(); ++w) {
+        column[w] = words[w].end;
+    }
+    write(column.data(), column.size() * sizeof(uint32_t));
+    for (size_t w = 0; w < words.size(); ++w) {
+        column[w] = encoded[w].size();
+    }
+    write(column.data(), column.size() * sizeof(uint32_t));
+    for (const auto& ids : encoded) {
+        write(ids.data(), ids.size() * sizeof(int32_t));
+    }
+}
+
+void TokenShardWriter::finish() {
+    if (finished) {
+        return;
+    }
+    finished = true;
+    pad(8);
+    write(offsets.data(), offsets.size() * sizeof(uint64_t));
+    uint64_t numDocs = offsets.size();
+    write(&numDocs, sizeof(numDocs));
+    write(MAGIC, sizeof(MAGIC));
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Failed to write file: " + path);
+    }
+}
+
+size_t TokenShardWriter::size() const {
+    return offsets.size();
+}
+
+TokenShard::TokenShard(const std::string& path) : file(path) {
+    const char* data = file.data();
+    size_t length = file.size();
+    if (length < HEADER_BYTES + TRAILER_BYTES ||
+        std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || std::memcmp(data + length - sizeof(MAGIC), MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not a token shard file: " + path);
+    }
+    uint32_t version;
+    std::memcpy(&version, data + sizeof(MAGIC), sizeof(version));
+    if (version != VERSION) {
+        throw std::runtime_error("Unsupported token shard version: " + path);
+    }
+    std::memcpy(&fingerprint, data + sizeof(MAGIC) + sizeof(VERSION), sizeof(fingerprint));
+
+    uint64_t docs;
+    std::memcpy(&docs, data + length - TRAILER_BYTES, sizeof(docs));
+    size_t indexStart = length - TRAILER_BYTES - docs * sizeof(uint64_t);
+    if (docs > (length - HEADER_BYTES - TRAILER_BYTES) / sizeof(uint64_t) || indexStart % 8 != 0) {
+        throw std::runtime_error("Corrupt token shard: " + path);
+    }
+    recordOffsets = reinterpret_cast<const uint64_t*>(data + indexStart);
+    numDocs = docs;
+
+    for (size_t d = 0; d < numDocs; ++d) {
+        uint64_t offset = recordOffsets[d];
+        if (offset % 8 != 0 || offset < HEADER_BYTES || offset + sizeof(Record) > indexStart) {
+            throw std::runtime_error("Corrupt token shard: " + path);
+        }
+        const Record& r = record(d);
+        uint64_t end = offset + sizeof(Record) + align4(r.textBytes) + uint64_t(r.numWords) * 3 * sizeof(uint32_t) +
+                       uint64_t(r.numIds) * sizeof(int32_t);
+        if (end > indexStart) {
+            throw std::runtime_error("Corrupt token shard: " + path);
+        }
+        // Words must lie within the text and the ids per word must add up to numIds.
+        const uint32_t* starts = wordStarts(d);
+        const uint32_t* ends = starts + r.numWords;
+        const uint32_t* counts = ends + r.numWords;
+        uint64_t ids = 0;
+        for (size_t w = 0; w < r.numWords; ++w) {
+            if (starts[w] > ends[w] || ends[w] > r.textBytes) {
+                throw std::runtime_error("Corrupt token shard: " + path);
+            }
+            ids += counts[w];
+        }
+        if (ids != r.numIds) {
+            throw std::runtime_error("Corrupt token shard: " + path);
+        }
+    }
+}
+
+const TokenShard::Record& TokenShard::record(size_t doc) const {
+    if (doc >= numDocs) {
+        throw std::out_of_range("Document index out of range of the token shard");
+    }
+    return *reinterpret_cast<const Record*>(file.data() + recordOffsets[doc]);
+}
+
+const uint32_t* TokenShard::wordStarts(size_t doc) const {
+    const Record& r = record(doc);
+    return reinterpret_cast<const uint32_t*>(reinterpret_cast<const char*>(&r) + sizeof(Record) + align4(r.textBytes));
+}
+
+size_t TokenShard::size() const {
+    return numDocs;
+}
+
+uint64_t TokenShard::tokenizerFingerprint() const {
+    return fingerprint;
+}
+
+std::string_view TokenShard::text(size_t doc) const {
+    const Record& r = record(doc);
+    return std::string_view(reinterpret_cast<const char*>(&r) + sizeof(Record), r.textBytes);
+}
+
+size_t TokenShard::numWords(size_t doc) const {
+    return record(doc).numWords;
+}
+
+size_t TokenShard::numTokens(size_t doc) const {
+    return record(doc).numIds;
+}
+
+std::vector<Token> TokenShard::words(size_t doc) const {
+    size_t n = numWords(doc);
+    const uint32_t* starts = wordStarts(doc);
+    const uint32_t* ends = starts + n;
+    std::vector<Token> out;
+    out.reserve(n);
+    for (size_t w = 0; w < n; ++w) {
+        out.push_back({starts[w], ends[w], std::string()});
+    }
+    return out;
+}
+
+std::vector<SubwordIds> TokenShard::subwordIds(size_t doc) const {
+    size_t n = numWords(doc);
+    const uint32_t* counts = wordStarts(doc) + 2 * n;
+    const int32_t* ids = reinterpret_cast<const int32_t*>(counts + n);
+    std::vector<SubwordIds> out;
+    out.reserve(n);
+    for (size_t w = 0; w < n; ++w) {
+        out.push_back({ids, counts[w]});
+        ids += counts[w];
+    }
+    return out;
+}
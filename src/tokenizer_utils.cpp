@@ -96,6 +96,16 @@ namespace gliner
         return data;
     }
 
+    uint64_t TokenizerFingerprint(const std::string &blob)
+    {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (unsigned char c : blob)
+        {
+            hash = (hash ^ c) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+
     WhitespaceTokenSplitter::WhitespaceTokenSplitter()
         : pimpl(std::make_unique<Implementation>())
     {
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""Writes a tiny stand-in span-level GLiNER model and tokenizer.
+
+The model has the inputs and output of a real span-level export, so the library
+and the tools run against it unchanged, but it computes no encoder: every
+single-word span gets logit 5 for the first label and every other span -5.
+Spans of a request are therefore fully predictable, which makes it suitable for
+localhost tests of the server and the tools.
+
+Usage: make_tiny_model.py OUT_DIR  (writes OUT_DIR/model.onnx and OUT_DIR/tokenizer.json)
+Needs the `onnx` Python package.
+"""
+
+import json
+import os
+import sys
+
+from onnx import TensorProto, checker, helper, save
+
+PAD_ID, CLS_ID, SEP_ID, UNK_ID, ENT_ID, PROMPT_SEP_ID = range(6)
+SPECIAL_TOKENS = ["[PAD]", "[CLS]", "[SEP]", "[UNK]", "<<ENT>>", "<<SEP>>"]
+WORDS = ["person", "city", "organization", "alice", "bob", "lives", "in", "paris", "london", "works", "at", "acme"]
+
+
+def make_model():
+    def const(name, value, dtype=TensorProto.INT64):
+        return helper.make_node("Constant", [], [name], value=helper.make_tensor(name, dtype, [], [value]))
+
+    def const_list(name, values):
+        return helper.make_node("Constant", [], [name], value=helper.make_tensor(name, TensorProto.INT64, [len(values)], values))
+
+    nodes = [
+        const("ent_id", ENT_ID),
+        const("zero", 0),
+        const("one", 1),
+        const_list("axis_words", [1]),
+        const_list("axis_last", [2]),
+        const_list("label_shape", [1, 1, -1]),
+        const("hit_logit", 5.0, TensorProto.FLOAT),
+        const("miss_logit", -5.0, TensorProto.FLOAT),
+        # Labels of a request: the largest number of <<ENT>> tokens in a row.
+        helper.make_node("Equal", ["input_ids", "ent_id"], ["ent_mask"]),
+        helper.make_node("Cast", ["ent_mask"], ["ent_flags"], to=TensorProto.INT64),
+        helper.make_node("ReduceSum", ["ent_flags", "axis_words"], ["ent_counts"], keepdims=0),
+        helper.make_node("ReduceMax", ["ent_counts"], ["num_labels"], keepdims=0),
+        helper.make_node("Range", ["zero", "num_labels", "one"], ["labels"]),
+        helper.make_node("Equal", ["labels", "zero"], ["first_label"]),
+        helper.make_node("Reshape", ["first_label", "label_shape"], ["first_label_3d"]),
+        # Single-word spans that are not padding.
+        helper.make_node("Gather", ["span_idx", "zero"], ["span_starts"], axis=2),
+        helper.make_node("Gather", ["span_idx", "one"], ["span_ends"], axis=2),
+        helper.make_node("Equal", ["span_starts", "span_ends"], ["single_word"]),
+        helper.make_node("And", ["single_word", "span_mask"], ["hit_spans"]),
+        helper.make_node("Unsqueeze", ["hit_spans", "axis_last"], ["hit_spans_3d"]),
+        helper.make_node("And", ["hit_spans_3d", "first_label_3d"], ["hits"]),
+        helper.make_node("Where", ["hits", "hit_logit", "miss_logit"], ["logits"]),
+    ]
+    inputs = [
+        helper.make_tensor_value_info("input_ids", TensorProto.INT64, ["batch", "tokens"]),
+        helper.make_tensor_value_info("attention_mask", TensorProto.INT64, ["batch", "tokens"]),
+        helper.make_tensor_value_info("words_mask", TensorProto.INT64, ["batch", "tokens"]),
+        helper.make_tensor_value_info("text_lengths", TensorProto.INT64, ["batch", 1]),
+        helper.make_tensor_value_info("span_idx", TensorProto.INT64, ["batch", "spans", 2]),
+        helper.make_tensor_value_info("span_mask", TensorProto.BOOL, ["batch", "spans"]),
+    ]
+    outputs = [helper.make_tensor_value_info("logits", TensorProto.FLOAT, ["batch", "spans", "labels"])]
+    graph = helper.make_graph(nodes, "tiny_gliner", inputs, outputs)
+    model = helper.make_model(graph, opset_imports=[helper.make_opsetid("", 13)], producer_name="make_tiny_model")
+    model.ir_version = 7
+    checker.check_model(model)
+    return model
+
+
+def make_tokenizer():
+    vocab = {token: i for i, token in enumerate(SPECIAL_TOKENS + WORDS)}
+    added = [
+        {"id": i, "content": token, "single_word": False, "lstrip": False, "rstrip": False,
+         "normalized": False, "special": True}
+        for i, token in enumerate(SPECIAL_TOKENS)
+    ]
+    return {
+        "version": "1.0",
+        "truncation": None,
+        "padding": None,
+        "added_tokens": added,
+        "normalizer": {"type": "Lowercase"},
+        "pre_tokenizer": {"type": "Whitespace"},
+        "post_processor": None,
+        "decoder": None,
+        "model": {"type": "WordLevel", "vocab": vocab, "unk_token": "[UNK]"},
+    }
+
+
+def main(out_dir):
+    os.makedirs(out_dir, exist_ok=True)
+    save(make_model(), os.path.join(out_dir, "model.onnx"))
+    with open(os.path.join(out_dir, "tokenizer.json"), "w") as f:
+        json.dump(make_tokenizer(), f)
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        print("Usage: make_tiny_model.py OUT_DIR", file=sys.stderr)
+        sys.exit(1)
+    main(sys.argv[1])
@@ -1,6 +1,13 @@
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <string>
+#include <atomic>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <thread>
 
 #include <gtest/gtest.h>
 
@@ -9,6 +16,21 @@
 #include "GLiNER/decoder.hpp"
 #include "GLiNER/model.hpp"
 #include "GLiNER/tokenizer_utils.hpp"
+#include "GLiNER/executor.hpp"
+#include "GLiNER/result_cache.hpp"
+#include "GLiNER/inference_result.hpp"
+#include "GLiNER/cancellation.hpp"
+#include "GLiNER/replica_runner.hpp"
+#include "GLiNER/cascade.hpp"
+#include "GLiNER/document_session.hpp"
+#include "GLiNER/dynamic_batcher.hpp"
+#include "GLiNER/autotuner.hpp"
+#include "GLiNER/model_format.hpp"
+#include "GLiNER/gazetteer.hpp"
+#include "GLiNER/token_shard.hpp"
+#include "GLiNER/reloadable_model.hpp"
+#include "GLiNER/pipeline.hpp"
+#include "GLiNER/arena.hpp"
 
 bool compare_tokens(gliner::Token t1, gliner::Token t2) {
     return t1.text == t2.text && t1.start == t2.start && t1.end == t2.end;
@@ -113,6 +135,176 @@ TEST(TestTopic, TestModelInference) {
     }
 }
 
+TEST(TestTopic, TestPretokenizedInference) {
+    gliner::Config config{12, 512};
+    std::string tokenizerPath = "/home/mvy/GLiNER.cpp/examples/gliner_small-v2.1/tokenizer.json";
+    gliner::Model model("/home/mvy/GLiNER.cpp/examples/gliner_small-v2.1/onnx/model.onnx", tokenizerPath, config);
+    auto tokenizer = tokenizers::Tokenizer::FromBlobJSON(gliner::LoadBytesFromFile(tokenizerPath));
+
+    std::vector<std::string> texts = {"Kyiv is the capital of Ukraine.", "Lviv is a city in western Ukraine."};
+    std::vector<std::string> entities = {"city", "country"};
+    gliner::WhitespaceTokenSplitter splitter;
+    std::vector<gliner::PretokenizedText> words(texts.size());
+    for (size_t i = 0; i < texts.size(); ++i) {
+        words[i].words = splitter.call(texts[i]);
+    }
+    auto expected = model.inference(texts, entities);
+
+    auto check = [&](const std::vector<std::vector<gliner::Span>>& output) {
+        ASSERT_EQ(output.size(), expected.size());
+        for (size_t i = 0; i < output.size(); ++i) {
+            ASSERT_EQ(output[i].size(), expected[i].size());
+            for (size_t j = 0; j < output[i].size(); ++j) {
+                EXPECT_TRUE(compare_spans(output[i][j], expected[i][j]));
+            }
+        }
+    };
+    check(model.inference(texts, words, entities));
+    for (size_t i = 0; i < texts.size(); ++i) {
+        for (const auto& word : words[i].words) {
+            words[i].subwordIds.push_back(tokenizer->Encode(texts[i].substr(word.start, word.end - word.start)));
+        }
+    }
+    check(model.inference(texts, words, entities));
+
+    auto badIds = words;
+    badIds[1].subwordIds.pop_back();
+    EXPECT_THROW(model.inference(texts, badIds, entities), std::invalid_argument);
+    auto badOffsets = words;
+    badOffsets[0].words.back().end = texts[0].size() + 1;
+    EXPECT_THROW(model.inference(texts, badOffsets, entities), std::invalid_argument);
+    badOffsets = words;
+    std::swap(badOffsets[0].words[0].start, badOffsets[0].words[0].end);
+    EXPECT_THROW(model.inference(texts, badOffsets, entities), std::invalid_argument);
+    EXPECT_THROW(model.inference(texts, {words[0]}, entities), std::invalid_argument);
+}
+
+TEST(TestTopic, TestTokenShard) {
+    gliner::Config config{12, 512};
+    std::string tokenizerPath = "/home/mvy/GLiNER.cpp/examples/gliner_small-v2.1/tokenizer.json";
+    gliner::Model model("/home/mvy/GLiNER.cpp/examples/gliner_small-v2.1/onnx/model.onnx", tokenizerPath, config);
+    std::vector<std::string> texts = {"Kyiv is the capital of Ukraine.", "", "Lviv is a city in western Ukraine."};
+    std::vector<std::string> entities = {"city", "country"};
+    std::string path = ::testing::TempDir() + "token_shard.bin";
+    {
+        gliner::TokenShardWriter writer(path, tokenizerPath);
+        for (const auto& text : texts) {
+            writer.add(text);
+        }
+        writer.finish();
+    }
+
+    gliner::TokenShard shard(path);
+    ASSERT_EQ(shard.size(), texts.size());
+    EXPECT_EQ(shard.tokenizerFingerprint(), gliner::TokenizerFingerprint(gliner::LoadBytesFromFile(tokenizerPath)));
+    gliner::WhitespaceTokenSplitter splitter;
+    for (size_t doc = 0; doc < texts.size(); ++doc) {
+        EXPECT_EQ(shard.text(doc), texts[doc]);
+        auto words = shard.words(doc);
+        auto expected = splitter.call(texts[doc]);
+        ASSERT_EQ(words.size(), expected.size());
+        for (size_t w = 0; w < words.size(); ++w) {
+            EXPECT_EQ(words[w].start, expected[w].start);
+            EXPECT_EQ(words[w].end, expected[w].end);
+        }
+        EXPECT_EQ(shard.subwordIds(doc).size(), words.size());
+    }
+    EXPECT_THROW(shard.text(texts.size()), std::out_of_range);
+
+    std::vector<std::string> batch = {texts[0], texts[2]};
+    auto expected = model.inference(batch, entities);
+    auto output = model.inference(shard, 2, 3, entities);
+    ASSERT_EQ(output.size(), size_t(1));
+    ASSERT_EQ(output[0].size(), expected[1].size());
+    for (size_t j = 0; j < output[0].size(); ++j) {
+        EXPECT_TRUE(compare_spans(output[0][j], expected[1][j]));
+    }
+    EXPECT_THROW(model.inference(shard, 1, 4, entities), std::out_of_range);
+
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto rewrite = [&](size_t offset, uint32_t value) {
+        std::string corrupt = bytes;
+        std::memcpy(&corrupt[offset], &value, sizeof(value));
+        std::ofstream(path, std::ios::binary) << corrupt;
+    };
+    // The first record follows the 16-byte header; its word starts follow the padded text.
+    size_t numWords = splitter.call(texts[0]).size();
+    size_t starts = 16 + 16 + (texts[0].size() + 3) / 4 * 4;
+    rewrite(starts + 4 * numWords, uint32_t(texts[0].size() + 1)); // first word ends past the text
+    EXPECT_THROW(gliner::TokenShard{path}, std::runtime_error);
+    rewrite(starts, 5); // first word starts after its end
+    EXPECT_THROW(gliner::TokenShard{path}, std::runtime_error);
+    rewrite(starts + 8 * numWords, 1000); // ids per word no longer add up to numIds
+    EXPECT_THROW(gliner::TokenShard{path}, std::runtime_error);
+
+    uint32_t fingerprint;
+    std::memcpy(&fingerprint, &bytes[8], sizeof(fingerprint));
+    rewrite(8, fingerprint ^ 1); // written with another tokenizer
+    gliner::TokenShard foreign(path);
+    EXPECT_THROW(model.inference(foreign, 0, 1, entities), std::invalid_argument);
+    std::remove(path.c_str());
+}
+
+TEST(TestTopic, TestPipelineMatchesModel) {
+    gliner::Config config{12, 512};
+    std::string modelPath = "/home/mvy/GLiNER.cpp/examples/gliner_small-v2.1/onnx/model.onnx";
+    std::string tokenizerPath = "/home/mvy/GLiNER.cpp/examples/gliner_small-v2.1/tokenizer.json";
+    gliner::Model model(modelPath, tokenizerPath, config);
+    Ort::Env env;
+    Ort::Session session(env, modelPath.c_str(), Ort::SessionOptions());
+    gliner::SpanPipeline runtimeWidth(session, tokenizerPath, config);
+    gliner::Pipeline<gliner::SPAN_LEVEL, 12> fixedWidth(session, tokenizerPath, config);
+
+    std::vector<std::vector<std::string>> batches = {
+        {"Kyiv is the capital of Ukraine.", "Lviv is a city in western Ukraine."},
+        {"Ukraine"}, // buffers of the previous call are reused for a smaller batch
+    };
+    std::vector<std::string> entities = {"city", "country"};
+    for (const auto& texts : batches) {
+        auto expected = model.inference(texts, entities);
+        for (const auto& output : {runtimeWidth.inference(texts, entities), fixedWidth.inference(texts, entities)}) {
+            ASSERT_EQ(output.size(), expected.size());
+            for (size_t i = 0; i < output.size(); ++i) {
+                ASSERT_EQ(output[i].size(), expected[i].size());
+                for (size_t j = 0; j < output[i].size(); ++j) {
+                    EXPECT_TRUE(compare_spans(output[i][j], expected[i][j]));
+                }
+            }
+        }
+    }
+}
+
+TEST(TestTopic, TestAsyncCallbackThrows) {
+    std::vector<std::string> texts = {"Kyiv is the capital of Ukraine."};
+    std::vector<std::string> entities = {"city", "country"};
+    for (bool runAsync : {false, true}) {
+        gliner::Config config{12, 512};
+        config.numWorkers = 2;
+        config.useRunAsync = runAsync;
+        gliner::Model model("/home/mvy/GLiNER.cpp/examples/gliner_small-v2.1/onnx/model.onnx", "/home/mvy/GLiNER.cpp/examples/gliner_small-v2.1/tokenizer.json", config);
+
+        std::atomic<int> calls{0};
+        for (int i = 0; i < 4; i++) {
+            model.inferenceAsync(texts, entities, [&](std::vector<std::vector<gliner::Span>>&&, std::exception_ptr) {
+                calls++;
+                throw std::runtime_error("callback failed");
+            });
+            model.inferenceAsync(texts, entities, gliner::RequestControl(),
+                [&](gliner::InferenceStatus, std::vector<std::vector<gliner::Span>>&&, std::exception_ptr) {
+                    calls++;
+                    throw 1;
+                });
+        }
+        model.waitIdle(); // every request still ends, so this returns
+        EXPECT_EQ(calls.load(), 8);
+        EXPECT_EQ(model.inferenceAsync(texts, entities).get().size(), size_t(1)); // the workers survived
+    }
+}
+
 TEST(TestTopic, TestUnicodes) {
     std::vector<gliner::Token> res_map = {
         {0, 6, "你好"}, 
@@ -145,4 +337,637 @@ TEST(TestTopic, TestUnicodes) {
         std::cout << "Expected: Word: " << expected_word.text << ", Start: " << expected_word.start << ", End: " << expected_word.end << std::endl;
         EXPECT_EQ(compare_tokens(word, res_map[i]), true);
     }
-}
\ No newline at end of file
+}
+
+TEST(TestTopic, TestExecutor) {
+    std::atomic<int> counter{0};
+    {
+        gliner::Executor executor(4);
+        EXPECT_EQ(executor.size(), size_t(4));
+        for (int i = 0; i < 100; i++) {
+            executor.submit([&counter] { counter++; });
+        }
+    } // destructor drains the queue
+    EXPECT_EQ(counter.load(), 100);
+}
+
+TEST(TestTopic, TestArena) {
+    gliner::Arena arena(1024, 8192);
+    void* first;
+    {
+        gliner::Arena::Scope scope(arena);
+        first = arena.resource()->allocate(512);
+        {
+            gliner::Arena::Scope nested(arena);
+            EXPECT_NE(arena.resource()->allocate(256), first); // only the outermost scope resets
+        }
+        EXPECT_NE(arena.resource()->allocate(128), first);
+    }
+    {
+        gliner::Arena::Scope scope(arena);
+        EXPECT_EQ(arena.resource()->allocate(512), first); // the block is reused after the reset
+    }
+    EXPECT_EQ(arena.blockSize(), size_t(1024));
+
+    {
+        gliner::Arena::Scope scope(arena);
+        arena.resource()->allocate(3000); // overflows to the heap
+    }
+    EXPECT_GT(arena.blockSize(), size_t(1024));
+    EXPECT_LE(arena.blockSize(), arena.maxBlockSize());
+
+    {
+        gliner::Arena::Scope scope(arena);
+        arena.resource()->allocate(1 << 20); // an outlier does not grow the block past the cap
+    }
+    EXPECT_EQ(arena.blockSize(), size_t(8192));
+    {
+        gliner::Arena::Scope scope(arena);
+        first = arena.resource()->allocate(4096);
+    }
+    {
+        gliner::Arena::Scope scope(arena);
+        EXPECT_EQ(arena.resource()->allocate(4096), first); // requests under the cap stay in the block
+    }
+    EXPECT_EQ(arena.blockSize(), size_t(8192));
+}
+
+TEST(TestTopic, TestResultCache) {
+    gliner::ResultCache cache(1 << 20, 4);
+    std::vector<std::string> entities = {"city", "country"};
+    auto params = gliner::ResultCache::paramsKey(entities, 0.5, true, false, "model");
+    auto key = gliner::ResultCache::textKey("Kyiv is the capital of Ukraine.", params);
+
+    std::string text = "Kyiv is the capital of Ukraine.";
+    std::vector<gliner::Span> spans;
+    EXPECT_EQ(cache.get(key, text, spans), false);
+    cache.put(key, text, {{0, 4, "Kyiv", "city", 0.9}});
+    EXPECT_EQ(cache.get(key, text, spans), true);
+    EXPECT_EQ(spans.size(), size_t(1));
+    EXPECT_EQ(spans[0].text, "Kyiv");
+
+    // Any decoding parameter is part of the key
+    auto otherParams = gliner::ResultCache::paramsKey(entities, 0.6, true, false, "model");
+    EXPECT_EQ(cache.get(gliner::ResultCache::textKey(text, otherParams), text, spans), false);
+
+    // A text whose key collides with a stored one does not get its spans
+    EXPECT_EQ(cache.get(key, "Lviv is a city in western Ukraine.", spans), false);
+
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.hits, uint64_t(1));
+    EXPECT_EQ(stats.misses, uint64_t(3));
+    EXPECT_EQ(stats.entries, size_t(1));
+}
+
+TEST(TestTopic, TestInferenceResultRedecode) {
+    gliner::WhitespaceTokenSplitter splitter;
+    gliner::InferenceResult result;
+    result.modelType = gliner::SPAN_LEVEL;
+    result.texts = {"Kyiv is big"};
+    result.entities = {"city"};
+    result.batchTokens = {splitter.call(result.texts[0])};
+    result.numWords = 3;
+    result.width = 2;
+    // [batch, startWord, width, entity] logits; only "Kyiv" is a confident city
+    result.logits = {5.0, -5.0, -1.0, -5.0, -5.0, -5.0};
+
+    gliner::SpanDecoder decoder;
+    auto spans = decoder.decode(result, true, 0.5);
+    EXPECT_EQ(spans[0].size(), size_t(1));
+    EXPECT_EQ(spans[0][0].text, "Kyiv");
+    EXPECT_EQ(decoder.decode(result, true, 0.2)[0].size(), size_t(2));
+    EXPECT_EQ(decoder.decode(result, true, 0.999)[0].size(), size_t(0));
+
+    std::string path = ::testing::TempDir() + "inference_result.bin";
+    result.save(path);
+    auto loaded = gliner::InferenceResult::load(path);
+    std::remove(path.c_str());
+    EXPECT_EQ(loaded.batchTokens[0][1].text, "is");
+    EXPECT_EQ(decoder.decode(loaded, true, 0.5)[0].size(), size_t(1));
+}
+
+TEST(TestTopic, TestInferenceResultLoadRejectsCorruption) {
+    gliner::WhitespaceTokenSplitter splitter;
+    gliner::InferenceResult result;
+    result.modelType = gliner::SPAN_LEVEL;
+    result.texts = {"Kyiv is big"};
+    result.entities = {"city"};
+    result.batchTokens = {splitter.call(result.texts[0])};
+    result.numWords = 3;
+    result.width = 2;
+    result.logits.assign(6, -5.0);
+    std::string path = ::testing::TempDir() + "corrupt_result.bin";
+
+    gliner::InferenceResult unmatched = result;
+    unmatched.batchTokens.clear(); // no word list for the text
+    EXPECT_THROW(unmatched.save(path), std::invalid_argument);
+
+    gliner::InferenceResult shape = result;
+    shape.logits.pop_back(); // not batch * words * width * entities
+    shape.save(path);
+    EXPECT_THROW(gliner::InferenceResult::load(path), std::runtime_error);
+
+    gliner::InferenceResult offsets = result;
+    offsets.batchTokens[0][2].end = 20; // past the end of the text
+    offsets.save(path);
+    EXPECT_THROW(gliner::InferenceResult::load(path), std::runtime_error);
+
+    // A logits count larger than the file must fail before allocating
+    result.save(path);
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    uint64_t huge = uint64_t(1) << 60;
+    std::memcpy(&bytes[bytes.size() - 6 * sizeof(float) - sizeof(uint64_t)], &huge, sizeof(huge));
+    std::ofstream(path, std::ios::binary) << bytes;
+    EXPECT_THROW(gliner::InferenceResult::load(path), std::runtime_error);
+
+    result.save(path);
+    EXPECT_EQ(gliner::InferenceResult::load(path).logits.size(), size_t(6));
+    std::remove(path.c_str());
+}
+
+TEST(TestTopic, TestRunStats) {
+    gliner::Config config{12, 512};
+    config.memory.shrinkAboveBytes = 1; // every run shrinks the arena
+    gliner::Model model("/home/mvy/GLiNER.cpp/examples/gliner_small-v2.1/onnx/model.onnx", "/home/mvy/GLiNER.cpp/examples/gliner_small-v2.1/tokenizer.json", config);
+
+    gliner::InferenceResult result = model.forward({"Kyiv is the capital of Ukraine."}, {"city", "country"});
+    EXPECT_GT(result.runStats.inputBytes, size_t(0));
+    EXPECT_EQ(result.runStats.outputBytes, result.logits.size() * sizeof(float));
+    EXPECT_TRUE(result.runStats.arenaShrunk);
+    gliner::MemoryStats stats = model.memoryStats();
+    EXPECT_EQ(stats.peakInputBytes, result.runStats.inputBytes);
+    EXPECT_EQ(stats.peakOutputBytes, result.runStats.outputBytes);
+    EXPECT_EQ(stats.arenaShrinks, uint64_t(1));
+
+    // A failed run is not counted: the model takes int64 inputs, not float ones
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    std::vector<float> data(2);
+    int64_t shape[] = {1, 2};
+    std::vector<Ort::Value> inputs;
+    for (int i = 0; i < 6; i++) {
+        inputs.push_back(Ort::Value::CreateTensor<float>(memory_info, data.data(), data.size(), shape, 2));
+    }
+    std::vector<float> output;
+    EXPECT_THROW(model.run(inputs, output), Ort::Exception);
+    EXPECT_EQ(model.memoryStats().arenaShrinks, uint64_t(1));
+}
+
+TEST(TestTopic, TestForwardWithoutEntities) {
+    gliner::Config config{12, 512};
+    gliner::Model model("/home/mvy/GLiNER.cpp/examples/gliner_small-v2.1/onnx/model.onnx", "/home/mvy/GLiNER.cpp/examples/gliner_small-v2.1/tokenizer.json", config);
+    gliner::InferenceResult result = model.forward({"Kyiv is the capital of Ukraine.", "Lviv"}, {});
+    ASSERT_EQ(result.batchTokens.size(), result.texts.size());
+
+    std::string path = ::testing::TempDir() + "empty_result.bin";
+    result.save(path);
+    auto loaded = gliner::InferenceResult::load(path);
+    std::remove(path.c_str());
+    EXPECT_EQ(loaded.texts, result.texts);
+    EXPECT_TRUE(model.decode(loaded).empty());
+}
+
+TEST(TestTopic, TestCascadeBand) {
+    gliner::WhitespaceTokenSplitter splitter;
+    gliner::InferenceResult first;
+    first.modelType = gliner::SPAN_LEVEL;
+    first.texts = {"Kyiv is big", "Lviv too", "No city", "Hello there"};
+    first.entities = {"city"};
+    for (const auto& text : first.texts) {
+        first.batchTokens.push_back(splitter.call(text));
+    }
+    first.numWords = 3;
+    first.width = 2;
+    // [batch, startWord, width, entity] logits: a confident span, one just above the
+    // threshold, one just below it and a text without any span
+    first.logits.assign(4 * 3 * 2, -5.0);
+    first.logits[0] = 5.0;          // "Kyiv" 0.99
+    first.logits[6] = 0.2;          // "Lviv" 0.55
+    first.logits[6 * 2 + 2] = -0.4; // "city" 0.40
+
+    gliner::SpanDecoder decoder;
+    gliner::CascadeConfig config{0.15, true};
+    auto results = decoder.decode(first, true, 0.5);
+    auto relaxed = decoder.decode(first, true, 0.5 - config.band);
+    ASSERT_EQ(results[1].size(), size_t(1));
+    EXPECT_TRUE(results[2].empty());
+    ASSERT_EQ(relaxed[2].size(), size_t(1));
+
+    EXPECT_EQ(gliner::Cascade::uncertainTexts(results, relaxed, 0.5, config), std::vector<size_t>({1, 2, 3}));
+    config.escalateEmpty = false;
+    EXPECT_EQ(gliner::Cascade::uncertainTexts(results, relaxed, 0.5, config), std::vector<size_t>({1, 2}));
+    config.band = 0.01;
+    relaxed = decoder.decode(first, true, 0.5 - config.band);
+    EXPECT_EQ(gliner::Cascade::uncertainTexts(results, relaxed, 0.5, config), std::vector<size_t>());
+}
+
+TEST(TestTopic, TestRequestControl) {
+    gliner::RequestControl unbounded;
+    EXPECT_TRUE(unbounded.check() == gliner::InferenceStatus::OK);
+
+    auto expired = gliner::RequestControl::withTimeout(std::chrono::milliseconds(-1));
+    EXPECT_TRUE(expired.check() == gliner::InferenceStatus::DEADLINE_EXCEEDED);
+
+    // Copies share the token, so cancelling one cancels the other
+    auto control = gliner::RequestControl::withTimeout(std::chrono::hours(1));
+    gliner::RequestControl copy = control;
+    EXPECT_TRUE(copy.check() == gliner::InferenceStatus::OK);
+    control.cancellation.cancel();
+    EXPECT_TRUE(copy.check() == gliner::InferenceStatus::CANCELLED);
+}
+
+TEST(TestTopic, TestReplicaPartition) {
+    auto sets = gliner::ReplicaRunner::partitionCores(2, 0, false);
+    ASSERT_EQ(sets.size(), size_t(2));
+    EXPECT_FALSE(sets[0].empty());
+    EXPECT_FALSE(sets[1].empty());
+    if (sets[0].size() + sets[1].size() > 2) {
+        // enough cores: the replicas do not share any
+        for (int cpu : sets[0]) {
+            EXPECT_TRUE(std::find(sets[1].begin(), sets[1].end(), cpu) == sets[1].end());
+        }
+    }
+
+    EXPECT_EQ(gliner::ReplicaRunner::partitionCores(1, 1, false)[0].size(), size_t(1));
+    // The calling thread is not listed; ids are 1-based
+    EXPECT_EQ(gliner::ReplicaRunner::affinityEntry({4, 5, 6}), "6;7");
+    EXPECT_EQ(gliner::ReplicaRunner::affinityEntry({4}), "");
+}
+
+TEST(TestTopic, TestReplicaWarmup) {
+    gliner::Config config{12, 512};
+    gliner::ReplicaConfig replicaConfig;
+    replicaConfig.numReplicas = 3;
+    replicaConfig.threadsPerReplica = 1;
+    replicaConfig.pinThreads = false;
+    gliner::ReplicaRunner runner(
+        "/home/mvy/GLiNER.cpp/examples/gliner_small-v2.1/onnx/model.onnx",
+        "/home/mvy/GLiNER.cpp/examples/gliner_small-v2.1/tokenizer.json", config, replicaConfig
+    );
+    runner.warmup({"Kyiv is the capital of Ukraine."}, {"city", "country"});
+
+    // Every replica ran the batch once, not whichever was idle first
+    for (const auto& stats : runner.stats()) {
+        EXPECT_EQ(stats.batches, uint64_t(1));
+        EXPECT_EQ(stats.texts, uint64_t(1));
+    }
+}
+
+TEST(TestTopic, TestWarmupTiming) {
+    gliner::WarmupTiming timing{{8, 128, 4}, {120.0, 31.0}};
+    EXPECT_FALSE(timing.stable());
+    timing.millis.push_back(30.0);
+    EXPECT_TRUE(timing.stable());
+    EXPECT_FALSE(timing.stable(0.01));
+}
+
+TEST(TestTopic, TestChunkerWindows) {
+    std::string text;
+    for (int i = 0; i < 300; i++) {
+        text += "word" + std::to_string(i) + (i % 17 == 16 ? ". " : " ");
+    }
+    gliner::ChunkConfig config;
+    config.minWords = 20;
+    config.maxWords = 50;
+    config.overlapWords = 5;
+    gliner::Chunker chunker(config);
+    auto windows = chunker.split(text);
+    ASSERT_TRUE(windows.size() > size_t(5));
+
+    // Cores tile the whole text and contexts contain their cores
+    EXPECT_EQ(windows.front().coreStart, size_t(0));
+    EXPECT_EQ(windows.back().coreEnd, text.size());
+    for (size_t w = 0; w < windows.size(); w++) {
+        EXPECT_TRUE(windows[w].contextStart <= windows[w].coreStart);
+        if (w > 0) {
+            EXPECT_EQ(windows[w].coreStart, windows[w - 1].coreEnd);
+        }
+    }
+
+    // An edit only moves the boundaries around it
+    std::string edited = text;
+    size_t at = text.find("word150");
+    edited.insert(at, "a few new words ");
+    auto after = chunker.split(edited);
+    size_t shift = edited.size() - text.size();
+    EXPECT_EQ(after.front().coreEnd, windows.front().coreEnd);
+    EXPECT_EQ(after.back().coreStart, windows.back().coreStart + shift);
+
+    // A long document without newlines is split in linear time
+    std::string flat;
+    for (int i = 0; i < 50000; i++) {
+        flat += "token" + std::to_string(i) + " ";
+    }
+    auto flatWindows = chunker.split(flat);
+    ASSERT_GE(flatWindows.size(), size_t(50000 / 50));
+    EXPECT_EQ(flatWindows.front().coreStart, size_t(0));
+    EXPECT_EQ(flatWindows.back().coreEnd, flat.size());
+    for (size_t w = 1; w < flatWindows.size(); w++) {
+        EXPECT_EQ(flatWindows[w].coreStart, flatWindows[w - 1].coreEnd);
+    }
+}
+
+TEST(TestTopic, TestColumnarSpans) {
+    gliner::WhitespaceTokenSplitter splitter;
+    std::vector<std::string> texts = {"Kyiv is big", "Lviv too"};
+    std::vector<std::vector<gliner::Token>> tokens = {splitter.call(texts[0]), splitter.call(texts[1])};
+    std::vector<std::string> entities = {"city"};
+    // [batch, startWord, width, entity] logits for 3 words and width 2
+    std::vector<float> logits = {5.0, -5.0, -5.0, -5.0, -5.0, -5.0, 4.0, -5.0, -5.0, -5.0, -5.0, -5.0};
+
+    gliner::SpanDecoder decoder;
+    gliner::ColumnarSpans columns;
+    decoder.decodeColumns(tokens, 3, 2, entities, logits, columns, true, 0.5);
+    ASSERT_EQ(columns.rows(), size_t(2));
+    ASSERT_EQ(columns.size(), size_t(2));
+    EXPECT_EQ(columns.rowOffsets[1], uint64_t(1));
+    EXPECT_EQ(columns.row[1], uint32_t(1));
+    EXPECT_EQ(columns.end[1], 4);
+    EXPECT_EQ(columns.labels[columns.labelId[1]], "city");
+
+    std::string path = ::testing::TempDir() + "columnar_spans.bin";
+    columns.save(path);
+    auto spans = gliner::ColumnarSpans::load(path).toSpans(texts);
+    std::remove(path.c_str());
+    EXPECT_EQ(spans[0][0].text, "Kyiv");
+    EXPECT_EQ(spans[1][0].text, "Lviv");
+}
+
+TEST(TestTopic, TestColumnarSpansLoadRejectsCorruption) {
+    gliner::ColumnarSpans columns;
+    columns.labels = {"city"};
+    columns.rowOffsets = {0, 1, 2};
+    columns.row = {0, 1};
+    columns.start = {0, 0};
+    columns.end = {4, 4};
+    columns.labelId = {0, 0};
+    columns.prob = {0.9f, 0.8f};
+    std::string path = ::testing::TempDir() + "corrupt_columns.bin";
+
+    auto rejects = [&](const gliner::ColumnarSpans& corrupt) {
+        corrupt.save(path);
+        EXPECT_THROW(gliner::ColumnarSpans::load(path), std::runtime_error);
+    };
+    gliner::ColumnarSpans bad = columns;
+    bad.rowOffsets = {0, 5, 2}; // decreasing, and past the spans
+    rejects(bad);
+    bad = columns;
+    bad.rowOffsets = {0, 1}; // does not end at the span count
+    rejects(bad);
+    bad = columns;
+    bad.row = {0, 0}; // second span is in row 1
+    rejects(bad);
+    bad = columns;
+    bad.labelId = {0, 1}; // one label only
+    rejects(bad);
+    bad = columns;
+    bad.start = {5, 0}; // starts after its end
+    rejects(bad);
+
+    // Counts larger than the file must fail before allocating
+    columns.save(path);
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    uint64_t huge = uint64_t(1) << 60;
+    size_t labelCount = 8, numSpans = 8 + 8 + 8 + 4 + 8;
+    for (size_t offset : {labelCount, numSpans}) {
+        std::string corrupt = bytes;
+        std::memcpy(&corrupt[offset], &huge, sizeof(huge));
+        std::ofstream(path, std::ios::binary) << corrupt;
+        EXPECT_THROW(gliner::ColumnarSpans::load(path), std::runtime_error);
+    }
+
+    columns.save(path);
+    auto loaded = gliner::ColumnarSpans::load(path);
+    std::remove(path.c_str());
+    EXPECT_EQ(loaded.toSpans({"Kyiv is big", "Lviv too"})[1][0].text, "Lviv");
+    EXPECT_THROW(loaded.toSpans({"Kyiv is big"}), std::invalid_argument);
+    EXPECT_THROW(loaded.toSpans({"Kyiv is big", "Lv"}), std::invalid_argument);
+}
+
+TEST(TestTopic, TestPerRowLabels) {
+    gliner::WhitespaceTokenSplitter splitter;
+    std::vector<std::string> texts = {"Kyiv is big", "Lviv too"};
+    std::vector<std::vector<std::string>> entities = {{"city", "person"}, {"city"}};
+    gliner::SpanBatch batch;
+    batch.batchTokens = {splitter.call(texts[0]), splitter.call(texts[1])};
+    batch.numWords = 3;
+    batch.maxWidth = 2;
+    // [batch, startWord, width, entity] logits padded to 2 labels; the second row
+    // has one label, so its scores in the "person" slot must be ignored
+    std::vector<float> logits(24, -5.0);
+    logits[1] = 5.0;       // row 0: "Kyiv" is a person
+    logits[12 + 1] = 5.0;  // row 1: padded slot
+    logits[12 + 4] = 4.0;  // row 1: "too" is a city
+
+    gliner::SpanDecoder decoder;
+    auto spans = decoder.decode(&batch, texts, entities, logits, true, 0.5);
+    ASSERT_EQ(spans[0].size(), size_t(1));
+    EXPECT_EQ(spans[0][0].classLabel, "person");
+    ASSERT_EQ(spans[1].size(), size_t(1));
+    EXPECT_EQ(spans[1][0].text, "too");
+    EXPECT_EQ(spans[1][0].classLabel, "city");
+}
+
+TEST(TestTopic, TestHistogram) {
+    gliner::Histogram histogram(gliner::Histogram::exponential(1, 2, 4)); // 1, 2, 4, 8
+    EXPECT_EQ(histogram.quantile(0.99), 0.0);
+    for (int i = 0; i < 98; i++) {
+        histogram.record(1.5);
+    }
+    histogram.record(7);
+    histogram.record(100);
+    EXPECT_EQ(histogram.count(), uint64_t(100));
+    EXPECT_EQ(histogram.counts()[1], uint64_t(98));
+    EXPECT_EQ(histogram.counts().back(), uint64_t(1)); // above the last bound
+    EXPECT_EQ(histogram.quantile(0.5), 2.0);
+    EXPECT_EQ(histogram.quantile(0.99), 8.0);
+    histogram.clear();
+    EXPECT_EQ(histogram.count(), uint64_t(0));
+}
+
+TEST(TestTopic, TestBatcherDropsExpired) {
+    gliner::Config config{12, 512};
+    gliner::Model model("/home/mvy/GLiNER.cpp/examples/gliner_small-v2.1/onnx/model.onnx", "/home/mvy/GLiNER.cpp/examples/gliner_small-v2.1/tokenizer.json", config);
+    gliner::DynamicBatcher batcher({&model});
+    std::vector<std::string> entities = {"city", "country"};
+
+    gliner::RequestControl expired;
+    expired.deadline = gliner::Clock::now() - std::chrono::seconds(1);
+    gliner::RequestControl cancelled;
+    cancelled.cancellation.cancel();
+    std::future<gliner::DynamicBatcher::Result> expiredResult, cancelledResult, liveResult;
+    ASSERT_TRUE(batcher.trySubmit({"Kyiv is the capital of Ukraine."}, entities, expired, expiredResult));
+    ASSERT_TRUE(batcher.trySubmit({"Kyiv is the capital of Ukraine."}, entities, cancelled, cancelledResult));
+    ASSERT_TRUE(batcher.trySubmit({"Kyiv is the capital of Ukraine."}, entities, liveResult));
+
+    EXPECT_EQ(liveResult.get().size(), size_t(1));
+    try {
+        expiredResult.get();
+        FAIL() << "expired request was run";
+    } catch (const gliner::RequestDropped& e) {
+        EXPECT_EQ(e.status, gliner::InferenceStatus::DEADLINE_EXCEEDED);
+    }
+    try {
+        cancelledResult.get();
+        FAIL() << "cancelled request was run";
+    } catch (const gliner::RequestDropped& e) {
+        EXPECT_EQ(e.status, gliner::InferenceStatus::CANCELLED);
+    }
+    gliner::BatcherMetrics metrics = batcher.metrics();
+    EXPECT_EQ(metrics.dropped, uint64_t(2));
+    EXPECT_EQ(metrics.texts, uint64_t(1));
+    EXPECT_EQ(metrics.queueDepth, size_t(0));
+}
+
+TEST(TestTopic, TestReloadUnderLoad) {
+    gliner::Config config{12, 512};
+    std::string modelPath = "/home/mvy/GLiNER.cpp/examples/gliner_small-v2.1/onnx/model.onnx";
+    std::string tokenizerPath = "/home/mvy/GLiNER.cpp/examples/gliner_small-v2.1/tokenizer.json";
+    gliner::ReloadableModel model(modelPath, tokenizerPath, config);
+    std::vector<std::string> texts = {"Kyiv is the capital of Ukraine."};
+    std::vector<std::string> entities = {"city", "country"};
+    auto expected = model.inference(texts, entities);
+
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> mismatches{0}, calls{0};
+    std::vector<std::thread> clients;
+    for (int t = 0; t < 4; ++t) {
+        clients.emplace_back([&] {
+            while (!stop) {
+                auto output = model.inference(texts, entities);
+                if (output.size() != 1 || output[0].size() != expected[0].size()) {
+                    mismatches++;
+                }
+                calls++;
+            }
+        });
+    }
+    for (int r = 0; r < 3; ++r) {
+        model.reload(modelPath, tokenizerPath).get();
+    }
+    stop = true;
+    for (auto& client : clients) {
+        client.join();
+    }
+    EXPECT_EQ(model.version(), uint64_t(4));
+    EXPECT_GT(calls.load(), size_t(0));
+    EXPECT_EQ(mismatches.load(), size_t(0));
+
+    // A retired instance stays usable while held, and the reloader waits for it before the next reload.
+    std::shared_ptr<gliner::Model> held = model.acquire();
+    model.reload(modelPath, tokenizerPath).get();
+    auto next = model.reload(modelPath, tokenizerPath);
+    EXPECT_EQ(next.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+    EXPECT_EQ(held->inference(texts, entities).size(), size_t(1));
+    held.reset();
+    next.get();
+    EXPECT_EQ(model.version(), uint64_t(6));
+
+    EXPECT_THROW(model.reload("/nonexistent/model.onnx", tokenizerPath).get(), std::exception);
+    EXPECT_EQ(model.version(), uint64_t(6));
+    EXPECT_EQ(model.inference(texts, entities).size(), size_t(1));
+}
+
+TEST(TestTopic, TestBatchAutotuner) {
+    gliner::AutotuneConfig tuning;
+    tuning.targetP99Millis = 50;
+    tuning.window = 4;
+    gliner::BatcherConfig initial;
+    initial.maxBatchSize = 16;
+    gliner::BatchAutotuner tuner(tuning, initial);
+
+    // Runs cost 2 ms + 0.01 ms per padded word; full batches with requests at 10 ms
+    auto run = [&tuner](size_t texts, size_t words, double requestMillis, size_t backlog) {
+        double runMillis = 2 + 0.01 * texts * words;
+        return tuner.observe(texts, words, runMillis, std::vector<double>(texts, requestMillis), backlog);
+    };
+    for (int i = 0; i < 3; i++) {
+        EXPECT_FALSE(run(16, 20 + i * 40, 10, 5));
+    }
+    EXPECT_TRUE(run(16, 140, 10, 5));
+    EXPECT_EQ(tuner.state().decisions, uint64_t(1));
+    EXPECT_NEAR(tuner.state().perTokenMillis, 0.01, 1e-6);
+    EXPECT_NEAR(tuner.state().runFixedMillis, 2, 1e-6);
+    EXPECT_NEAR(double(tuner.current().maxTokens), 2300, 1); // (50 * 0.5 - 2) / 0.01
+    EXPECT_EQ(tuner.current().maxBatchSize, size_t(18));
+
+    // Over the target: shrink
+    for (int i = 0; i < 4; i++) {
+        run(18, 50, 80, 0);
+    }
+    EXPECT_EQ(tuner.current().maxBatchSize, size_t(12));
+    EXPECT_TRUE(tuner.current().maxWait < initial.maxWait);
+}
+
+TEST(TestTopic, TestInspectModelFile) {
+    // ONNX: op_type strings with a one-byte length; a longer name must not match its suffix
+    std::string onnx = std::string("\x08\x07") + "\x22\x0d" + "MatMulInteger" + "\x22\x15" + "DynamicQuantizeLinear";
+    std::string onnxPath = ::testing::TempDir() + "model_format.onnx";
+    std::string ortPath = ::testing::TempDir() + "model_format.ort";
+    std::ofstream(onnxPath, std::ios::binary) << onnx;
+    gliner::ModelFileInfo info = gliner::inspectModelFile(onnxPath);
+    EXPECT_EQ(info.format, gliner::ONNX_FORMAT);
+    EXPECT_EQ(info.bytes, onnx.size());
+    EXPECT_EQ(info.quantizedOps, std::vector<std::string>({"DynamicQuantizeLinear", "MatMulInteger"}));
+
+    // ORT: flatbuffer identifier after the root offset, strings with a uint32 length
+    std::string ort = std::string("\x10\0\0\0ORTM", 8) + std::string("\x0b\0\0\0", 4) + "MatMulNBits";
+    std::ofstream(ortPath, std::ios::binary) << ort;
+    info = gliner::inspectModelFile(ortPath);
+    EXPECT_EQ(gliner::detectModelFormat(ortPath), gliner::ORT_FORMAT);
+    EXPECT_EQ(info.quantizedOps, std::vector<std::string>({"MatMulNBits"}));
+
+    std::ofstream(onnxPath, std::ios::binary) << "\x08\x07no quantization";
+    EXPECT_FALSE(gliner::inspectModelFile(onnxPath).quantized());
+    std::remove(onnxPath.c_str());
+    std::remove(ortPath.c_str());
+}
+
+TEST(TestTopic, TestGazetteer) {
+    gliner::Gazetteer gazetteer({
+        {"product", {"Acme Rocket 3000", "rocket"}, 1.0, true},
+        {"team", {"rocket team"}, 0.9, false}
+    });
+    gliner::WhitespaceTokenSplitter splitter;
+    std::string text = "The ACME rocket team shipped the acme rocket 3000.";
+    std::vector<gliner::Token> words = splitter.call(text);
+
+    std::vector<gliner::GazetteerMatch> found;
+    gazetteer.match(text, words, found);
+    ASSERT_EQ(found.size(), size_t(4));
+    EXPECT_EQ(found[0].startWord, size_t(2)); // "rocket"
+    EXPECT_EQ(found[0].label, uint32_t(0));
+    EXPECT_EQ(found[1].startWord, size_t(2)); // "rocket team", through the fail link of "acme rocket"
+    EXPECT_EQ(found[1].endWord, size_t(3));
+    EXPECT_EQ(found[1].label, uint32_t(1));
+    EXPECT_EQ(found[2].startWord, size_t(7)); // "rocket" inside "acme rocket 3000"
+    EXPECT_EQ(found[3].startWord, size_t(6));
+    EXPECT_EQ(found[3].endWord, size_t(8));
+
+    gliner::GazetteerPlan plan = gazetteer.plan({"person", "product", "team"});
+    EXPECT_TRUE(plan.matches);
+    EXPECT_EQ(plan.prompt, std::vector<std::string>({"person", "team"}));
+    EXPECT_EQ(plan.labels, std::vector<std::string>({"person", "team", "product"}));
+    EXPECT_EQ(plan.entityOf, std::vector<int>({2, 1}));
+    EXPECT_FALSE(gazetteer.plan({"person"}).matches);
+
+    // Dictionary candidates alone, merged and selected like model spans
+    std::vector<std::vector<gliner::SpanCandidate>> extra(1);
+    for (const auto& match : found) {
+        extra[0].push_back({int(words[match.startWord].start), int(words[match.endWord].end),
+                            plan.entityOf[match.label], gazetteer.score(match.label)});
+    }
+    gliner::SpanDecoder decoder;
+    auto spans = decoder.decodeMerged(nullptr, {text}, plan.labels, 2, {}, extra, true, 0.5);
+    ASSERT_EQ(spans[0].size(), size_t(2));
+    EXPECT_EQ(spans[0][0].text, "rocket");
+    EXPECT_EQ(spans[0][0].classLabel, "product");
+    EXPECT_EQ(spans[0][1].text, "acme rocket 3000");
+}
@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+"""Localhost test of gliner_server against the stand-in model of make_tiny_model.py.
+
+Usage: test_server.py PATH_TO_GLINER_SERVER
+Exits with 77 (skipped) when the `onnx` Python package is not installed.
+"""
+
+import http.client
+import json
+import os
+import signal
+import socket
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+try:
+    import make_tiny_model
+except ImportError:
+    print("SKIPPED: the onnx Python package is not installed")
+    sys.exit(77)
+
+MAX_WAIT_US = 1000000  # long enough to keep a lone request queued while the test fills the queue
+
+
+def free_port():
+    with socket.socket() as s:
+        s.bind(("127.0.0.1", 0))
+        return s.getsockname()[1]
+
+
+def http_request(port, method, path, body=None):
+    conn = http.client.HTTPConnection("127.0.0.1", port, timeout=30)
+    try:
+        conn.request(method, path, body=body, headers={"Content-Type": "application/json"} if body else {})
+        response = conn.getresponse()
+        return response.status, dict(response.getheaders()), response.read().decode()
+    finally:
+        conn.close()
+
+
+def extract(port, request):
+    status, headers, body = http_request(port, "POST", "/v1/extract", json.dumps(request))
+    return status, headers, json.loads(body)
+
+
+def metric(port, name):
+    status, _, body = http_request(port, "GET", "/metrics")
+    assert status == 200, status
+    for line in body.splitlines():
+        if line.startswith(name + " "):
+            return float(line.split()[1])
+    raise AssertionError("missing metric " + name)
+
+
+def check_spans(spans, text, label):
+    # The stand-in model tags every word, and only single words, with the first label.
+    words = text.split()
+    assert [span["text"] for span in spans] == words, spans
+    assert all(span["label"] == label for span in spans), spans
+    assert all(span["score"] > 0.9 for span in spans), spans
+
+
+def main(server_path):
+    with tempfile.TemporaryDirectory() as tmp:
+        make_tiny_model.main(tmp)
+        port = free_port()
+        socket_path = os.path.join(tmp, "gliner.sock")
+        server = subprocess.Popen([
+            server_path, "--model", os.path.join(tmp, "model.onnx"), "--tokenizer", os.path.join(tmp, "tokenizer.json"),
+            "--labels", "person,city", "--port", str(port), "--socket", socket_path,
+            "--max-batch", "16", "--max-wait-us", str(MAX_WAIT_US), "--max-queue", "1",
+        ])
+        try:
+            deadline = time.time() + 60
+            while True:
+                try:
+                    if http_request(port, "GET", "/health")[0] == 200:
+                        break
+                except OSError:
+                    pass
+                assert server.poll() is None, "server exited with %s" % server.returncode
+                assert time.time() < deadline, "server did not start"
+                time.sleep(0.1)
+
+            status, headers, body = http_request(port, "GET", "/health")
+            assert status == 200 and body == "ok\n", (status, body)
+
+            # HTTP front-end, with labels from the request and from --labels.
+            status, _, response = extract(port, {"texts": ["Alice lives in Paris"], "labels": ["city", "person"]})
+            assert status == 200, response
+            assert len(response["spans"]) == 1
+            check_spans(response["spans"][0], "Alice lives in Paris", "city")
+            status, _, response = extract(port, {"text": "Bob works at Acme", "threshold": 0.5})
+            assert status == 200, response
+            check_spans(response["spans"][0], "Bob works at Acme", "person")
+
+            # Malformed requests.
+            for request in ({"labels": ["city"]}, {"texts": "Alice"}, {"text": "Alice", "threshold": "high"},
+                            {"text": "Alice", "flat_ner": 1}, {"text": "Alice", "multi_label": "yes"}):
+                status, _, response = extract(port, request)
+                assert status == 400 and "error" in response, (request, status, response)
+            assert http_request(port, "GET", "/missing")[0] == 404
+
+            # Unix socket front-end, two requests on one connection.
+            with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as client:
+                client.settimeout(30)
+                client.connect(socket_path)
+                client.sendall(b'{"text": "Alice lives in London"}\n{"texts": ["Paris"], "labels": ["city"]}\n')
+                lines = b""
+                while lines.count(b"\n") < 2:
+                    chunk = client.recv(65536)
+                    assert chunk, "connection closed"
+                    lines += chunk
+                first, second = [json.loads(line) for line in lines.splitlines()]
+                check_spans(first["spans"][0], "Alice lives in London", "person")
+                check_spans(second["spans"][0], "Paris", "city")
+
+            # Back-pressure: a lone request waits up to --max-wait-us for company and holds the
+            # whole queue meanwhile, so the next one is rejected.
+            queued = {}
+            waiting = threading.Thread(target=lambda: queued.update(result=extract(port, {"text": "Alice"})))
+            waiting.start()
+            deadline = time.time() + MAX_WAIT_US / 1e6 / 2
+            while metric(port, "gliner_queue_depth") < 1:
+                assert time.time() < deadline, "request was not queued"
+                time.sleep(0.01)
+            status, headers, response = extract(port, {"text": "Bob"})
+            assert status == 503 and headers.get("Retry-After") == "1", (status, headers, response)
+            waiting.join()
+            status, _, response = queued["result"]
+            assert status == 200, response
+            check_spans(response["spans"][0], "Alice", "person")
+
+            assert metric(port, "gliner_rejected_total") == 1
+            assert metric(port, "gliner_requests_total") == 5
+            assert metric(port, "gliner_texts_total") == 5
+            assert metric(port, "gliner_queue_depth") == 0
+            assert metric(port, "gliner_request_latency_ms_count") == 5
+
+            # A port in use is reported cleanly, after the socket listener already started.
+            busy = subprocess.run([
+                server_path, "--model", os.path.join(tmp, "model.onnx"), "--tokenizer", os.path.join(tmp, "tokenizer.json"),
+                "--port", str(port), "--socket", os.path.join(tmp, "busy.sock"),
+            ], stderr=subprocess.PIPE, timeout=60)
+            assert busy.returncode == 1 and b"Cannot listen on http://" in busy.stderr, busy.stderr
+            assert not os.path.exists(os.path.join(tmp, "busy.sock"))
+        finally:
+            server.send_signal(signal.SIGTERM)
+            assert server.wait(timeout=30) == 0, server.returncode
+        assert not os.path.exists(socket_path)
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        print("Usage: test_server.py PATH_TO_GLINER_SERVER", file=sys.stderr)
+        sys.exit(1)
+    main(sys.argv[1])
+    print("OK")
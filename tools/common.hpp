@@ -0,0 +1,70 @@
+#pragma once
+
+// Command-line helpers shared by the tools: option lists and text corpora.
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "json.hpp"
+
+namespace gliner::tools {
+    // Splits a comma-separated option value, skipping empty items.
+    inline std::vector<std::string> splitList(const std::string& s) {
+        std::vector<std::string> out;
+        size_t start = 0;
+        while (start <= s.size()) {
+            size_t end = s.find(',', start);
+            if (end == std::string::npos) {
+                end = s.size();
+            }
+            if (end > start) {
+                out.push_back(s.substr(start, end - start));
+            }
+            start = end + 1;
+        }
+        return out;
+    }
+
+    // Non-empty texts of a corpus: one text per line, or with `jsonl` the string
+    // `field` of every JSON line. Stops after maxTexts texts unless it is 0.
+    inline std::vector<std::string> loadTexts(
+        const std::string& path, bool jsonl = false, const std::string& field = "text", size_t maxTexts = 0
+    ) {
+        std::ifstream file(path);
+        if (!file) {
+            throw std::runtime_error("Cannot open input file: " + path);
+        }
+        std::vector<std::string> texts;
+        std::string line, text;
+        size_t lineNumber = 0;
+        while (std::getline(file, line) && (maxTexts == 0 || texts.size() < maxTexts)) {
+            lineNumber++;
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.empty()) {
+                continue;
+            }
+            if (!jsonl) {
+                texts.push_back(line);
+                continue;
+            }
+            std::string_view value;
+            if (!json::findField(line, field, value) || !json::parseString(value, text)) {
+                std::cerr << "WARNING! Line " << lineNumber << ": no string field '" << field << "'." << std::endl;
+                continue;
+            }
+            if (!text.empty()) {
+                texts.push_back(text);
+            }
+        }
+        if (texts.empty()) {
+            throw std::runtime_error("No texts in " + path);
+        }
+        return texts;
+    }
+}
@@ -0,0 +1,276 @@
+// Speed/accuracy comparison of two model files, e.g. an FP32 ONNX model and its
+// INT8 quantized or ORT-format variant.
+//
+// Both models tag the same local corpus with the same length-sorted batches, one
+// after the other so they do not compete for cores. The report gives load time,
+// throughput and batch latency percentiles for each model, and the span-level
+// agreement of model B with model A: a span agrees when start, end and label match
+// exactly, precision is taken over B's spans and recall over A's.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "GLiNER/gliner_config.hpp"
+#include "GLiNER/model.hpp"
+#include "GLiNER/model_format.hpp"
+#include "common.hpp"
+#include "json.hpp"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::string modelA;
+        std::string modelB;
+        std::string tokenizerPath;
+        std::string tokenizerB; // default: tokenizerPath
+        std::string inputPath;
+        std::vector<std::string> labels;
+        std::string field = "text";
+        bool jsonl = true;
+        size_t batchSize = 8;
+        size_t maxTexts = 0;
+        size_t warmupBatches = 1;
+        int threads = 0;
+        float threshold = 0.5;
+        bool flatNer = true;
+        bool multiLabel = false;
+        bool tokenLevel = false;
+        bool int8Qdq = false;
+        int maxWidth = 12;
+        int maxLength = 512;
+    };
+
+    void printUsage() {
+        std::cerr <<
+            "Usage: gliner_compare --model-a A.onnx --model-b B.onnx|B.ort --tokenizer tokenizer.json --labels a,b,c --input CORPUS [options]\n"
+            "  --tokenizer-b PATH   tokenizer of model B (default: --tokenizer)\n"
+            "  --format jsonl|text  input format (default: jsonl)\n"
+            "  --field NAME         JSON field holding the text (default: text)\n"
+            "  --max-texts N        use the first N texts only (default: all)\n"
+            "  --batch-size N       texts per session run (default: 8)\n"
+            "  --warmup N           untimed batches before measuring (default: 1)\n"
+            "  --threads N          intra-op threads (default: all cores)\n"
+            "  --threshold X        span probability threshold (default: 0.5)\n"
+            "  --nested             allow nested spans\n"
+            "  --multi-label        allow several labels per span\n"
+            "  --int8-qdq           keep int8 QDQ kernels for QDQ-quantized models\n"
+            "  --token-level        models are token-level GLiNERs\n"
+            "  --max-width N        maximum span width in words (default: 12)\n"
+            "  --max-length N       maximum sequence length in tokens (default: 512)\n";
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opts) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::runtime_error("Missing value for " + arg);
+                }
+                return argv[++i];
+            };
+            if (arg == "--model-a") opts.modelA = next();
+            else if (arg == "--model-b") opts.modelB = next();
+            else if (arg == "--tokenizer") opts.tokenizerPath = next();
+            else if (arg == "--tokenizer-b") opts.tokenizerB = next();
+            else if (arg == "--input") opts.inputPath = next();
+            else if (arg == "--labels") opts.labels = gliner::tools::splitList(next());
+            else if (arg == "--format") opts.jsonl = next() != "text";
+            else if (arg == "--field") opts.field = next();
+            else if (arg == "--max-texts") opts.maxTexts = std::stoul(next());
+            else if (arg == "--batch-size") opts.batchSize = std::stoul(next());
+            else if (arg == "--warmup") opts.warmupBatches = std::stoul(next());
+            else if (arg == "--threads") opts.threads = std::stoi(next());
+            else if (arg == "--threshold") opts.threshold = std::stof(next());
+            else if (arg == "--nested") opts.flatNer = false;
+            else if (arg == "--multi-label") opts.multiLabel = true;
+            else if (arg == "--int8-qdq") opts.int8Qdq = true;
+            else if (arg == "--token-level") opts.tokenLevel = true;
+            else if (arg == "--max-width") opts.maxWidth = std::stoi(next());
+            else if (arg == "--max-length") opts.maxLength = std::stoi(next());
+            else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                return false;
+            }
+        }
+        return !opts.modelA.empty() && !opts.modelB.empty() && !opts.tokenizerPath.empty() &&
+               !opts.inputPath.empty() && !opts.labels.empty();
+    }
+
+    struct RunReport {
+        gliner::ModelFileInfo file;
+        gliner::ModelFormat loadedAs = gliner::ONNX_FORMAT;
+        double loadSeconds = 0;
+        double runSeconds = 0; // warm-up batches excluded
+        std::vector<double> batchMillis;
+        std::vector<std::vector<gliner::Span>> spans; // per text, in corpus order
+    };
+
+    double percentile(std::vector<double> values, double q) {
+        if (values.empty()) {
+            return 0;
+        }
+        size_t k = std::min(values.size() - 1, size_t(std::ceil(q * values.size())) - (q > 0));
+        std::nth_element(values.begin(), values.begin() + k, values.end());
+        return values[k];
+    }
+
+    RunReport run(
+        const Options& opts, const std::string& modelPath, const std::string& tokenizerPath,
+        const std::vector<std::string>& texts, const std::vector<std::vector<size_t>>& batches
+    ) {
+        RunReport report;
+        report.file = gliner::inspectModelFile(modelPath);
+
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "gliner_compare");
+        Ort::SessionOptions sessionOptions;
+        sessionOptions.SetIntraOpNumThreads(opts.threads > 0 ? opts.threads : int(std::max(1u, std::thread::hardware_concurrency())));
+        sessionOptions.SetGraphOptimizationLevel(ORT_ENABLE_ALL);
+        gliner::Config config{opts.maxWidth, opts.maxLength, opts.tokenLevel ? gliner::TOKEN_LEVEL : gliner::SPAN_LEVEL};
+        config.load.int8Qdq = opts.int8Qdq;
+
+        auto start = Clock::now();
+        gliner::Model model(modelPath, tokenizerPath, config, env, sessionOptions);
+        report.loadSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        report.loadedAs = model.format();
+
+        report.spans.resize(texts.size());
+        std::vector<std::string> batch;
+        auto tag = [&](const std::vector<size_t>& indices) {
+            batch.clear();
+            for (size_t i : indices) {
+                batch.push_back(texts[i]);
+            }
+            return model.inference(batch, opts.labels, opts.flatNer, opts.threshold, opts.multiLabel);
+        };
+        // Untimed batches so that arena growth and first-run initialization are not measured.
+        for (size_t b = 0; b < std::min(opts.warmupBatches, batches.size()); b++) {
+            tag(batches[b]);
+        }
+        for (const auto& indices : batches) {
+            start = Clock::now();
+            auto spans = tag(indices);
+            double millis = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            report.batchMillis.push_back(millis);
+            report.runSeconds += millis / 1000;
+            for (size_t k = 0; k < spans.size(); k++) {
+                report.spans[indices[k]] = std::move(spans[k]);
+            }
+        }
+        return report;
+    }
+
+    void printRun(const char* name, const std::string& path, const RunReport& report) {
+        std::string ops;
+        for (const auto& op : report.file.quantizedOps) {
+            ops += (ops.empty() ? "" : ",") + op;
+        }
+        std::printf("model %s: %s\n", name, path.c_str());
+        std::printf("  format %s, %.1f MB, quantized: %s, load %.2f s\n",
+                    gliner::formatName(report.loadedAs), report.file.bytes / 1048576.0,
+                    ops.empty() ? "no" : ops.c_str(), report.loadSeconds);
+        std::printf("  %.1f texts/s over %zu texts, batch latency ms p50 %.1f p90 %.1f p99 %.1f max %.1f\n",
+                    report.runSeconds > 0 ? report.spans.size() / report.runSeconds : 0.0, report.spans.size(),
+                    percentile(report.batchMillis, 0.5), percentile(report.batchMillis, 0.9),
+                    percentile(report.batchMillis, 0.99), percentile(report.batchMillis, 1.0));
+    }
+
+    struct Agreement {
+        size_t spansA = 0;
+        size_t spansB = 0;
+        size_t matched = 0;
+        double probDiff = 0; // sum of |probA - probB| over matched spans
+
+        void print(const char* name) const {
+            double precision = spansB > 0 ? double(matched) / spansB : 1.0;
+            double recall = spansA > 0 ? double(matched) / spansA : 1.0;
+            double f1 = precision + recall > 0 ? 2 * precision * recall / (precision + recall) : 0.0;
+            std::printf("  %-20s precision %.4f recall %.4f f1 %.4f  (A %zu, B %zu, matched %zu, mean |dp| %.4f)\n",
+                        name, precision, recall, f1, spansA, spansB, matched, matched > 0 ? probDiff / matched : 0.0);
+        }
+    };
+
+    void compare(const RunReport& a, const RunReport& b) {
+        using Key = std::tuple<int, int, std::string>;
+        Agreement total;
+        std::map<std::string, Agreement> byLabel;
+        for (size_t i = 0; i < a.spans.size(); i++) {
+            std::map<Key, float> reference;
+            for (const auto& span : a.spans[i]) {
+                reference[Key(span.startIdx, span.endIdx, span.classLabel)] = span.prob;
+                total.spansA++;
+                byLabel[span.classLabel].spansA++;
+            }
+            for (const auto& span : b.spans[i]) {
+                total.spansB++;
+                Agreement& label = byLabel[span.classLabel];
+                label.spansB++;
+                auto it = reference.find(Key(span.startIdx, span.endIdx, span.classLabel));
+                if (it != reference.end()) {
+                    double diff = std::abs(it->second - span.prob);
+                    total.matched++;
+                    total.probDiff += diff;
+                    label.matched++;
+                    label.probDiff += diff;
+                }
+            }
+        }
+        std::printf("agreement of B with A (exact start, end and label):\n");
+        total.print("all labels");
+        for (const auto& [label, agreement] : byLabel) {
+            agreement.print(label.c_str());
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opts;
+    try {
+        if (!parseArgs(argc, argv, opts)) {
+            printUsage();
+            return 1;
+        }
+        opts.batchSize = std::max<size_t>(1, opts.batchSize);
+        if (opts.tokenizerB.empty()) {
+            opts.tokenizerB = opts.tokenizerPath;
+        }
+
+        std::vector<std::string> texts = gliner::tools::loadTexts(opts.inputPath, opts.jsonl, opts.field, opts.maxTexts);
+        // Length-sorted batches, shared by both models.
+        std::vector<size_t> order(texts.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&texts](size_t x, size_t y) {
+            return texts[x].size() < texts[y].size();
+        });
+        std::vector<std::vector<size_t>> batches;
+        for (size_t begin = 0; begin < order.size(); begin += opts.batchSize) {
+            size_t end = std::min(begin + opts.batchSize, order.size());
+            batches.emplace_back(order.begin() + begin, order.begin() + end);
+        }
+
+        RunReport a = run(opts, opts.modelA, opts.tokenizerPath, texts, batches);
+        printRun("A", opts.modelA, a);
+        RunReport b = run(opts, opts.modelB, opts.tokenizerB, texts, batches);
+        printRun("B", opts.modelB, b);
+        if (a.runSeconds > 0 && b.runSeconds > 0) {
+            std::printf("speedup of B over A: %.2fx\n", a.runSeconds / b.runSeconds);
+        }
+        compare(a, b);
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
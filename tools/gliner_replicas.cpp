@@ -0,0 +1,164 @@
+// Throughput benchmark for ReplicaRunner.
+//
+// Runs the same set of batches through runners with a different number of
+// session replicas K (cores split evenly between them) and prints texts/s for
+// each K, so the best partitioning of a machine can be picked empirically.
+// Texts repeated within a batch are computed once and counted once.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "GLiNER/gliner_config.hpp"
+#include "GLiNER/replica_runner.hpp"
+#include "common.hpp"
+
+namespace {
+    struct Options {
+        std::string modelPath;
+        std::string tokenizerPath;
+        std::string inputPath;
+        std::vector<std::string> labels;
+        std::vector<size_t> replicas = {1, 2, 4};
+        size_t batchSize = 8;
+        size_t batches = 64;
+        bool numaLocal = false;
+        bool pinThreads = true;
+        bool tokenLevel = false;
+        int maxWidth = 12;
+        int maxLength = 512;
+    };
+
+    void printUsage() {
+        std::cerr <<
+            "Usage: gliner_replicas --model MODEL.onnx --tokenizer tokenizer.json --labels a,b,c [options]\n"
+            "  --input PATH         plain-text file, one text per line (default: built-in sample)\n"
+            "  --replicas 1,2,4     replica counts to compare (default: 1,2,4)\n"
+            "  --batch-size N       texts per batch (default: 8)\n"
+            "  --batches N          batches per measurement, at least 1 (default: 64)\n"
+            "  --numa               keep each replica on one NUMA node\n"
+            "  --no-pin             do not set thread affinities\n"
+            "  --token-level        model is a token-level GLiNER\n"
+            "  --max-width N        maximum span width in words (default: 12)\n"
+            "  --max-length N       maximum sequence length in tokens (default: 512)\n";
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opts) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::runtime_error("Missing value for " + arg);
+                }
+                return argv[++i];
+            };
+            if (arg == "--model") opts.modelPath = next();
+            else if (arg == "--tokenizer") opts.tokenizerPath = next();
+            else if (arg == "--input") opts.inputPath = next();
+            else if (arg == "--labels") opts.labels = gliner::tools::splitList(next());
+            else if (arg == "--replicas") {
+                opts.replicas.clear();
+                for (const auto& k : gliner::tools::splitList(next())) {
+                    opts.replicas.push_back(std::stoul(k));
+                }
+            }
+            else if (arg == "--batch-size") opts.batchSize = std::stoul(next());
+            else if (arg == "--batches") opts.batches = std::stoul(next());
+            else if (arg == "--numa") opts.numaLocal = true;
+            else if (arg == "--no-pin") opts.pinThreads = false;
+            else if (arg == "--token-level") opts.tokenLevel = true;
+            else if (arg == "--max-width") opts.maxWidth = std::stoi(next());
+            else if (arg == "--max-length") opts.maxLength = std::stoi(next());
+            else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                return false;
+            }
+        }
+        return !opts.modelPath.empty() && !opts.tokenizerPath.empty() && !opts.labels.empty() && !opts.replicas.empty();
+    }
+
+    std::vector<std::string> loadTexts(const Options& opts) {
+        if (!opts.inputPath.empty()) {
+            return gliner::tools::loadTexts(opts.inputPath);
+        }
+        return {
+            "Kyiv is the capital and most populous city of Ukraine, located on the Dnieper river.",
+            "Apple Inc. was founded by Steve Jobs, Steve Wozniak and Ronald Wayne in April 1976 in Los Altos.",
+            "The European Central Bank kept interest rates unchanged on Thursday, President Christine Lagarde said in Frankfurt.",
+            "Cristiano Ronaldo scored twice as Portugal beat Luxembourg 6-0 in a Euro 2024 qualifier in Faro."
+        };
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opts;
+    try {
+        if (!parseArgs(argc, argv, opts)) {
+            printUsage();
+            return 1;
+        }
+        opts.batchSize = std::max<size_t>(1, opts.batchSize);
+        if (opts.batches == 0) {
+            throw std::runtime_error("--batches must be at least 1");
+        }
+
+        // Texts repeated within a batch are computed once by the model, so only distinct
+        // texts are counted; batches cycle through the corpus to keep repeats rare.
+        std::vector<std::string> texts = loadTexts(opts);
+        std::vector<std::vector<std::string>> batches(opts.batches);
+        size_t computedTexts = 0;
+        for (size_t b = 0; b < batches.size(); b++) {
+            for (size_t k = 0; k < opts.batchSize; k++) {
+                batches[b].push_back(texts[(b * opts.batchSize + k) % texts.size()]);
+            }
+            computedTexts += std::unordered_set<std::string>(batches[b].begin(), batches[b].end()).size();
+        }
+        if (opts.batchSize > texts.size()) {
+            std::cerr << "WARNING! Only " << texts.size() << " distinct texts for batches of " << opts.batchSize
+                      << "; texts/s counts each distinct text once per batch." << std::endl;
+        }
+
+        gliner::Config config{opts.maxWidth, opts.maxLength, opts.tokenLevel ? gliner::TOKEN_LEVEL : gliner::SPAN_LEVEL};
+        std::printf("%8s %8s %12s %12s %9s\n", "replicas", "threads", "texts/s", "batches/s", "speedup");
+        double baseline = 0;
+        for (size_t k : opts.replicas) {
+            gliner::ReplicaConfig replicaConfig;
+            replicaConfig.numReplicas = k;
+            replicaConfig.numaLocal = opts.numaLocal;
+            replicaConfig.pinThreads = opts.pinThreads;
+            gliner::ReplicaRunner runner(opts.modelPath, opts.tokenizerPath, config, replicaConfig);
+
+            // One untimed batch on every replica so arena allocation is not measured.
+            runner.warmup(batches[0], opts.labels);
+
+            std::vector<std::future<std::vector<std::vector<gliner::Span>>>> results;
+            auto start = std::chrono::steady_clock::now();
+            for (const auto& batch : batches) {
+                results.push_back(runner.submit(batch, opts.labels));
+            }
+            for (auto& result : results) {
+                result.get();
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            double textsPerSecond = double(computedTexts) / seconds;
+            if (baseline == 0) {
+                baseline = textsPerSecond;
+            }
+            std::printf(
+                "%8zu %8zu %12.1f %12.2f %8.2fx\n",
+                runner.size(), runner.stats()[0].cores.size(), textsPerSecond, double(batches.size()) / seconds, textsPerSecond / baseline
+            );
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,632 @@
+// Local inference server.
+//
+// Owns one or more sessions behind a DynamicBatcher and accepts JSON requests
+// from other processes on the same host, so requests of many clients are tagged
+// in shared batches. Two front-ends are available:
+//   - a Unix domain socket speaking newline-delimited JSON, one request per line
+//     and one response per line;
+//   - a minimal HTTP/1.1 listener bound to 127.0.0.1 with POST /v1/extract,
+//     GET /metrics (Prometheus text format) and GET /health.
+// A request is {"texts": [...], "labels": [...]} with optional "threshold",
+// "flat_ner" and "multi_label"; "text" may be used for a single text and
+// "labels" defaults to --labels. The response is {"spans": [[...], ...]}, or
+// {"error": "..."} with HTTP status 400, 500, 503 when the queue is full or
+// 504 when the request waited in the queue for longer than --timeout-ms.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "GLiNER/autotuner.hpp"
+#include "GLiNER/dynamic_batcher.hpp"
+#include "GLiNER/gliner_config.hpp"
+#include "GLiNER/model.hpp"
+#include "common.hpp"
+#include "json.hpp"
+
+namespace {
+    struct Options {
+        std::string modelPath;
+        std::string tokenizerPath;
+        std::vector<std::string> labels;
+        std::string socketPath;
+        int port = 8080;
+        size_t sessions = 1;
+        int threadsPerSession = 0;
+        long timeoutMillis = 0;
+        size_t maxConnections = 256;
+        gliner::BatcherConfig batcher;
+        gliner::AutotuneConfig autotune;
+        bool autotuneEnabled = false;
+        float threshold = 0.5;
+        bool tokenLevel = false;
+        int maxWidth = 12;
+        int maxLength = 512;
+    };
+
+    const size_t MAX_HEADER_BYTES = 64 << 10;
+    const size_t MAX_BODY_BYTES = 16 << 20;
+
+    void printUsage() {
+        std::cerr <<
+            "Usage: gliner_server --model MODEL.onnx --tokenizer tokenizer.json [options]\n"
+            "  --socket PATH        Unix domain socket for newline-delimited JSON (default: none)\n"
+            "  --port N             HTTP port on 127.0.0.1, 0 to disable (default: 8080)\n"
+            "  --labels a,b,c       labels used when a request has none\n"
+            "  --sessions N         sessions running batches in parallel (default: 1)\n"
+            "  --threads N          intra-op threads per session (default: cores / sessions)\n"
+            "  --max-batch N        texts per session run (default: 16)\n"
+            "  --max-tokens N       texts * longest text in words per run, 0 for no limit (default: 0)\n"
+            "  --max-wait-us N      how long a partial batch waits for more requests (default: 2000)\n"
+            "  --max-queue N        queued texts before requests are rejected (default: 1024)\n"
+            "  --timeout-ms N       drop requests not started within N ms, 0 for no limit (default: 0)\n"
+            "  --max-connections N  open client connections, each served by one thread (default: 256)\n"
+            "  --slo-p99-ms X       tune batch size, token budget and wait online to keep the request p99 under X\n"
+            "  --threshold X        default span probability threshold (default: 0.5)\n"
+            "  --token-level        model is a token-level GLiNER\n"
+            "  --max-width N        maximum span width in words (default: 12)\n"
+            "  --max-length N       maximum sequence length in tokens (default: 512)\n";
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opts) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::runtime_error("Missing value for " + arg);
+                }
+                return argv[++i];
+            };
+            if (arg == "--model") opts.modelPath = next();
+            else if (arg == "--tokenizer") opts.tokenizerPath = next();
+            else if (arg == "--labels") opts.labels = gliner::tools::splitList(next());
+            else if (arg == "--socket") opts.socketPath = next();
+            else if (arg == "--port") opts.port = std::stoi(next());
+            else if (arg == "--sessions") opts.sessions = std::stoul(next());
+            else if (arg == "--threads") opts.threadsPerSession = std::stoi(next());
+            else if (arg == "--max-batch") opts.batcher.maxBatchSize = std::stoul(next());
+            else if (arg == "--max-tokens") opts.batcher.maxTokens = std::stoul(next());
+            else if (arg == "--max-wait-us") opts.batcher.maxWait = std::chrono::microseconds(std::stol(next()));
+            else if (arg == "--max-queue") opts.batcher.maxQueueTexts = std::stoul(next());
+            else if (arg == "--timeout-ms") opts.timeoutMillis = std::stol(next());
+            else if (arg == "--max-connections") opts.maxConnections = std::stoul(next());
+            else if (arg == "--slo-p99-ms") {
+                opts.autotune.targetP99Millis = std::stod(next());
+                opts.autotuneEnabled = true;
+            }
+            else if (arg == "--threshold") opts.threshold = std::stof(next());
+            else if (arg == "--token-level") opts.tokenLevel = true;
+            else if (arg == "--max-width") opts.maxWidth = std::stoi(next());
+            else if (arg == "--max-length") opts.maxLength = std::stoi(next());
+            else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                return false;
+            }
+        }
+        bool listening = !opts.socketPath.empty() || opts.port > 0;
+        return !opts.modelPath.empty() && !opts.tokenizerPath.empty() && listening;
+    }
+
+    std::string errorBody(const std::string& message) {
+        std::string out = "{\"error\":";
+        gliner::json::appendString(out, message);
+        out += "}";
+        return out;
+    }
+
+    // Parses and runs one JSON request; returns the response body and sets an HTTP status.
+    std::string handleRequest(std::string_view body, const Options& opts, gliner::DynamicBatcher& batcher, int& status) {
+        std::vector<std::string> texts;
+        std::vector<std::string> labels = opts.labels;
+        float threshold = opts.threshold;
+        bool flatNer = true;
+        bool multiLabel = false;
+
+        std::string_view value;
+        std::string text;
+        double number;
+        if (gliner::json::findField(body, "texts", value)) {
+            if (!gliner::json::parseStringArray(value, texts)) {
+                status = 400;
+                return errorBody("'texts' must be an array of strings");
+            }
+        } else if (gliner::json::findField(body, "text", value)) {
+            if (!gliner::json::parseString(value, text)) {
+                status = 400;
+                return errorBody("'text' must be a string");
+            }
+            texts.push_back(std::move(text));
+        }
+        if (gliner::json::findField(body, "labels", value) && !gliner::json::parseStringArray(value, labels)) {
+            status = 400;
+            return errorBody("'labels' must be an array of strings");
+        }
+        if (gliner::json::findField(body, "threshold", value)) {
+            if (!gliner::json::parseNumber(value, number)) {
+                status = 400;
+                return errorBody("'threshold' must be a number");
+            }
+            threshold = float(number);
+        }
+        if (gliner::json::findField(body, "flat_ner", value) && !gliner::json::parseBool(value, flatNer)) {
+            status = 400;
+            return errorBody("'flat_ner' must be a boolean");
+        }
+        if (gliner::json::findField(body, "multi_label", value) && !gliner::json::parseBool(value, multiLabel)) {
+            status = 400;
+            return errorBody("'multi_label' must be a boolean");
+        }
+        if (texts.empty() || labels.empty()) {
+            status = 400;
+            return errorBody("A request needs 'texts' and 'labels'");
+        }
+
+        try {
+            std::future<gliner::DynamicBatcher::Result> result;
+            gliner::RequestControl control;
+            if (opts.timeoutMillis > 0) {
+                control = gliner::RequestControl::withTimeout(std::chrono::milliseconds(opts.timeoutMillis));
+            }
+            if (!batcher.trySubmit(std::move(texts), std::move(labels), control, result, flatNer, threshold, multiLabel)) {
+                status = 503;
+                return errorBody("Server is overloaded");
+            }
+            auto spans = result.get();
+            std::string out = "{\"spans\":[";
+            for (size_t i = 0; i < spans.size(); i++) {
+                if (i > 0) {
+                    out.push_back(',');
+                }
+                gliner::json::appendSpans(out, spans[i]);
+            }
+            out += "]}";
+            status = 200;
+            return out;
+        } catch (const std::invalid_argument& e) {
+            status = 400;
+            return errorBody(e.what());
+        } catch (const gliner::RequestDropped& e) {
+            status = 504;
+            return errorBody(e.what());
+        } catch (const std::exception& e) {
+            status = 500;
+            return errorBody(e.what());
+        }
+    }
+
+    void appendHistogram(std::string& out, const std::string& name, const gliner::Histogram& histogram) {
+        out += "# TYPE " + name + " histogram\n";
+        uint64_t cumulative = 0;
+        char buf[128];
+        for (size_t i = 0; i < histogram.bounds().size(); i++) {
+            cumulative += histogram.counts()[i];
+            std::snprintf(buf, sizeof(buf), "%s_bucket{le=\"%g\"} %llu\n", name.c_str(), histogram.bounds()[i],
+                          static_cast<unsigned long long>(cumulative));
+            out += buf;
+        }
+        out += name + "_bucket{le=\"+Inf\"} " + std::to_string(histogram.count()) + "\n";
+        std::snprintf(buf, sizeof(buf), "%s_sum %g\n", name.c_str(), histogram.sum());
+        out += buf;
+        out += name + "_count " + std::to_string(histogram.count()) + "\n";
+    }
+
+    std::string renderMetrics(const gliner::DynamicBatcher& batcher) {
+        gliner::BatcherMetrics metrics = batcher.metrics();
+        std::string out;
+        out += "# TYPE gliner_queue_depth gauge\ngliner_queue_depth " + std::to_string(metrics.queueDepth) + "\n";
+        out += "# TYPE gliner_queue_requests gauge\ngliner_queue_requests " + std::to_string(metrics.queueRequests) + "\n";
+        out += "# TYPE gliner_requests_total counter\ngliner_requests_total " + std::to_string(metrics.requests) + "\n";
+        out += "# TYPE gliner_rejected_total counter\ngliner_rejected_total " + std::to_string(metrics.rejected) + "\n";
+        out += "# TYPE gliner_dropped_total counter\ngliner_dropped_total " + std::to_string(metrics.dropped) + "\n";
+        out += "# TYPE gliner_batches_total counter\ngliner_batches_total " + std::to_string(metrics.batches) + "\n";
+        out += "# TYPE gliner_texts_total counter\ngliner_texts_total " + std::to_string(metrics.texts) + "\n";
+        out += "# TYPE gliner_max_batch_size gauge\ngliner_max_batch_size " + std::to_string(metrics.limits.maxBatchSize) + "\n";
+        out += "# TYPE gliner_max_tokens gauge\ngliner_max_tokens " + std::to_string(metrics.limits.maxTokens) + "\n";
+        out += "# TYPE gliner_max_wait_us gauge\ngliner_max_wait_us " + std::to_string(metrics.limits.maxWait.count()) + "\n";
+        out += "# TYPE gliner_autotune_decisions_total counter\ngliner_autotune_decisions_total " + std::to_string(metrics.autotuneDecisions) + "\n";
+        char buf[96];
+        std::snprintf(buf, sizeof(buf), "# TYPE gliner_autotune_p99_ms gauge\ngliner_autotune_p99_ms %g\n", metrics.autotuneP99Millis);
+        out += buf;
+        appendHistogram(out, "gliner_batch_size", metrics.batchSizes);
+        appendHistogram(out, "gliner_run_latency_ms", metrics.runMillis);
+        appendHistogram(out, "gliner_request_latency_ms", metrics.requestMillis);
+        return out;
+    }
+
+    bool readMore(int fd, std::string& buffer) {
+        char chunk[16 << 10];
+        while (true) {
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n > 0) {
+                buffer.append(chunk, n);
+                return true;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+    }
+
+    bool writeAll(int fd, std::string_view data) {
+        while (!data.empty()) {
+            ssize_t n = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            data.remove_prefix(n);
+        }
+        return true;
+    }
+
+    // Client connections and the threads serving them. Threads of closed connections are
+    // joined when the next connection starts, and shutdown unblocks and joins the rest.
+    class Connections {
+    private:
+        struct Connection {
+            int fd = -1;
+            bool closed = false;
+            std::thread thread;
+        };
+        std::mutex mutex;
+        std::condition_variable slotFreed;
+        std::list<Connection> connections;
+        size_t maxOpen;
+        size_t open = 0;
+        bool closing = false;
+
+        void finish(std::list<Connection>::iterator connection) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ::close(connection->fd);
+            connection->closed = true;
+            open--;
+            slotFreed.notify_one();
+        }
+    public:
+        explicit Connections(size_t maxOpen) : maxOpen(std::max<size_t>(1, maxOpen)) {}
+
+        // Serves fd on a new thread and closes it afterwards. Waits while maxOpen connections
+        // are being served, so further clients queue in the listen backlog; returns false once
+        // shutting down.
+        bool start(int fd, std::function<void(int)> serve) {
+            std::vector<std::thread> finished;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                slotFreed.wait(lock, [this] { return closing || open < maxOpen; });
+                if (closing) {
+                    return false;
+                }
+                for (auto it = connections.begin(); it != connections.end();) {
+                    if (it->closed) {
+                        finished.push_back(std::move(it->thread));
+                        it = connections.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+                auto connection = connections.emplace(connections.end());
+                connection->fd = fd;
+                open++;
+                // The thread cannot finish before it is stored: finish() waits for the lock.
+                connection->thread = std::thread([this, connection, serve = std::move(serve)] {
+                    serve(connection->fd);
+                    finish(connection);
+                });
+            }
+            for (auto& thread : finished) {
+                thread.join();
+            }
+            return true;
+        }
+        void closeAll() {
+            std::vector<std::thread> threads;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                closing = true;
+                slotFreed.notify_all();
+                for (auto& connection : connections) {
+                    if (!connection.closed) {
+                        ::shutdown(connection.fd, SHUT_RDWR);
+                    }
+                    if (connection.thread.joinable()) { // already taken by an earlier closeAll
+                        threads.push_back(std::move(connection.thread));
+                    }
+                }
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
+    };
+
+    class Server {
+    private:
+        const Options& opts;
+        gliner::DynamicBatcher& batcher;
+        Connections connections;
+        std::vector<int> listeners;
+        std::vector<std::thread> acceptors;
+
+        void serveLines(int fd) {
+            std::string buffer;
+            size_t begin = 0;
+            while (true) {
+                size_t end = buffer.find('\n', begin);
+                if (end == std::string::npos) {
+                    buffer.erase(0, begin);
+                    begin = 0;
+                    if (buffer.size() > MAX_BODY_BYTES || !readMore(fd, buffer)) {
+                        return;
+                    }
+                    continue;
+                }
+                std::string_view line(buffer.data() + begin, end - begin);
+                begin = end + 1;
+                if (gliner::json::skipWhitespace(line, 0) == line.size()) {
+                    continue;
+                }
+                int status;
+                std::string response = handleRequest(line, opts, batcher, status);
+                response.push_back('\n');
+                if (!writeAll(fd, response)) {
+                    return;
+                }
+            }
+        }
+
+        void serveHttp(int fd) {
+            std::string buffer;
+            while (true) {
+                size_t headerEnd;
+                while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+                    if (buffer.size() > MAX_HEADER_BYTES || !readMore(fd, buffer)) {
+                        return;
+                    }
+                }
+                std::string_view head(buffer.data(), headerEnd);
+                size_t lineEnd = head.find("\r\n");
+                std::string_view requestLine = head.substr(0, lineEnd);
+                size_t sp1 = requestLine.find(' ');
+                size_t sp2 = requestLine.find(' ', sp1 + 1);
+                if (sp1 == std::string_view::npos || sp2 == std::string_view::npos) {
+                    writeAll(fd, "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+                    return;
+                }
+                std::string method(requestLine.substr(0, sp1));
+                std::string target(requestLine.substr(sp1 + 1, sp2 - sp1 - 1));
+                bool keepAlive = requestLine.substr(sp2 + 1) == "HTTP/1.1";
+
+                size_t contentLength = 0;
+                size_t pos = lineEnd == std::string_view::npos ? head.size() : lineEnd + 2;
+                while (pos < head.size()) {
+                    size_t end = head.find("\r\n", pos);
+                    if (end == std::string_view::npos) {
+                        end = head.size();
+                    }
+                    std::string header(head.substr(pos, end - pos));
+                    std::transform(header.begin(), header.end(), header.begin(), [](unsigned char c) { return std::tolower(c); });
+                    if (header.rfind("content-length:", 0) == 0) {
+                        contentLength = std::strtoull(header.c_str() + 15, nullptr, 10);
+                    } else if (header.rfind("connection:", 0) == 0) {
+                        keepAlive = header.find("close") == std::string::npos;
+                    }
+                    pos = end + 2;
+                }
+                if (contentLength > MAX_BODY_BYTES) {
+                    writeAll(fd, "HTTP/1.1 413 Payload Too Large\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+                    return;
+                }
+                size_t bodyStart = headerEnd + 4;
+                while (buffer.size() < bodyStart + contentLength) {
+                    if (!readMore(fd, buffer)) {
+                        return;
+                    }
+                }
+                std::string_view body(buffer.data() + bodyStart, contentLength);
+
+                int status = 200;
+                std::string contentType = "application/json";
+                std::string response;
+                if (method == "GET" && target == "/metrics") {
+                    contentType = "text/plain; version=0.0.4";
+                    response = renderMetrics(batcher);
+                } else if (method == "GET" && target == "/health") {
+                    contentType = "text/plain";
+                    response = "ok\n";
+                } else if (method == "POST" && target == "/v1/extract") {
+                    response = handleRequest(body, opts, batcher, status);
+                } else {
+                    status = 404;
+                    response = errorBody("Not found");
+                }
+
+                const char* reason = status == 200 ? "OK" : status == 400 ? "Bad Request" : status == 404 ? "Not Found"
+                                   : status == 503 ? "Service Unavailable" : status == 504 ? "Gateway Timeout"
+                                   : "Internal Server Error";
+                std::string out = "HTTP/1.1 " + std::to_string(status) + " " + reason + "\r\n";
+                out += "Content-Type: " + contentType + "\r\n";
+                out += "Content-Length: " + std::to_string(response.size()) + "\r\n";
+                if (status == 503) {
+                    out += "Retry-After: 1\r\n";
+                }
+                out += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+                out += response;
+                if (!writeAll(fd, out) || !keepAlive) {
+                    return;
+                }
+                buffer.erase(0, bodyStart + contentLength);
+            }
+        }
+
+        void acceptLoop(int listener, bool http) {
+            while (true) {
+                int fd = ::accept(listener, nullptr, nullptr);
+                if (fd < 0) {
+                    if (errno == EINTR || errno == ECONNABORTED) {
+                        continue;
+                    }
+                    return; // listener shut down
+                }
+                bool started = connections.start(fd, [this, http](int fd) {
+                    if (http) {
+                        serveHttp(fd);
+                    } else {
+                        serveLines(fd);
+                    }
+                });
+                if (!started) {
+                    ::close(fd);
+                    return;
+                }
+            }
+        }
+
+        void listenOn(int fd, sockaddr* address, socklen_t length, const std::string& name, bool http) {
+            if (fd < 0 || ::bind(fd, address, length) != 0 || ::listen(fd, 128) != 0) {
+                std::string error = std::strerror(errno);
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+                throw std::runtime_error("Cannot listen on " + name + ": " + error);
+            }
+            listeners.push_back(fd);
+            acceptors.emplace_back(&Server::acceptLoop, this, fd, http);
+            std::cerr << "Listening on " << name << std::endl;
+        }
+
+        void listen() {
+            if (!opts.socketPath.empty()) {
+                sockaddr_un address{};
+                address.sun_family = AF_UNIX;
+                if (opts.socketPath.size() >= sizeof(address.sun_path)) {
+                    throw std::runtime_error("Socket path is too long: " + opts.socketPath);
+                }
+                std::strcpy(address.sun_path, opts.socketPath.c_str());
+                ::unlink(opts.socketPath.c_str());
+                int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+                listenOn(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address), opts.socketPath, false);
+            }
+            if (opts.port > 0) {
+                sockaddr_in address{};
+                address.sin_family = AF_INET;
+                address.sin_port = htons(static_cast<uint16_t>(opts.port));
+                address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+                int reuse = 1;
+                if (fd >= 0) {
+                    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+                }
+                listenOn(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address), "http://127.0.0.1:" + std::to_string(opts.port), true);
+            }
+        }
+    public:
+        Server(const Options& opts, gliner::DynamicBatcher& batcher)
+            : opts(opts), batcher(batcher), connections(opts.maxConnections) {}
+
+        // On failure, listeners already started are stopped before the error is rethrown.
+        void start() {
+            try {
+                listen();
+            } catch (...) {
+                stop();
+                throw;
+            }
+        }
+
+        // Stops accepting, unblocks idle clients and waits for running requests to finish.
+        void stop() {
+            for (int fd : listeners) {
+                ::shutdown(fd, SHUT_RDWR);
+            }
+            connections.closeAll(); // also releases an acceptor waiting for a free connection slot
+            for (auto& acceptor : acceptors) {
+                acceptor.join();
+            }
+            for (int fd : listeners) {
+                ::close(fd);
+            }
+            acceptors.clear();
+            listeners.clear();
+            if (!opts.socketPath.empty()) {
+                ::unlink(opts.socketPath.c_str());
+            }
+        }
+    };
+}
+
+int main(int argc, char** argv) {
+    Options opts;
+    try {
+        if (!parseArgs(argc, argv, opts)) {
+            printUsage();
+            return 1;
+        }
+        opts.sessions = std::max<size_t>(1, opts.sessions);
+
+        // Signals are taken by sigwait below, so every thread started from here blocks them.
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "gliner_server");
+        Ort::SessionOptions sessionOptions;
+        int threads = opts.threadsPerSession;
+        if (threads <= 0) {
+            threads = std::max(1, int(std::thread::hardware_concurrency() / opts.sessions));
+        }
+        sessionOptions.SetIntraOpNumThreads(threads);
+        sessionOptions.SetGraphOptimizationLevel(ORT_ENABLE_ALL);
+
+        gliner::Config config{opts.maxWidth, opts.maxLength, opts.tokenLevel ? gliner::TOKEN_LEVEL : gliner::SPAN_LEVEL};
+        std::vector<std::unique_ptr<gliner::Model>> models;
+        std::vector<gliner::Model*> sessions;
+        for (size_t s = 0; s < opts.sessions; s++) {
+            models.push_back(std::make_unique<gliner::Model>(
+                opts.modelPath, opts.tokenizerPath, config, env, sessionOptions
+            ));
+            sessions.push_back(models.back().get());
+        }
+
+        gliner::DynamicBatcher batcher(sessions, opts.batcher);
+        if (opts.autotuneEnabled) {
+            batcher.enableAutotune(opts.autotune);
+        }
+        Server server(opts, batcher);
+        server.start();
+
+        int signal = 0;
+        sigwait(&signals, &signal);
+        std::cerr << "Shutting down" << std::endl;
+        server.stop();
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+// Pre-tokenizes a corpus into a binary token shard.
+//
+// Every record (JSONL or plain text, one per line) is split into words and
+// encoded once; the shard is then memory-mapped with gliner::TokenShard and
+// tagged with Model::inference(shard, begin, end, labels) as many times as
+// needed, e.g. with other label sets or thresholds, without re-tokenizing.
+// Document d of the shard is the d-th non-empty record of the input.
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "GLiNER/mapped_file.hpp"
+#include "GLiNER/token_shard.hpp"
+#include "json.hpp"
+
+namespace {
+    struct Options {
+        std::string tokenizerPath;
+        std::string inputPath;
+        std::string outputPath;
+        std::string field = "text";
+        bool jsonl = true;
+    };
+
+    void printUsage() {
+        std::cerr <<
+            "Usage: gliner_shard --tokenizer tokenizer.json --input CORPUS --output CORPUS.shard [options]\n"
+            "  --format jsonl|text  input format (default: jsonl)\n"
+            "  --field NAME         JSON field holding the text (default: text)\n";
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opts) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::runtime_error("Missing value for " + arg);
+                }
+                return argv[++i];
+            };
+            if (arg == "--tokenizer") opts.tokenizerPath = next();
+            else if (arg == "--input") opts.inputPath = next();
+            else if (arg == "--output") opts.outputPath = next();
+            else if (arg == "--format") opts.jsonl = next() != "text";
+            else if (arg == "--field") opts.field = next();
+            else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                return false;
+            }
+        }
+        return !opts.tokenizerPath.empty() && !opts.inputPath.empty() && !opts.outputPath.empty();
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opts;
+    try {
+        if (!parseArgs(argc, argv, opts)) {
+            printUsage();
+            return 1;
+        }
+
+        gliner::MappedFile input(opts.inputPath);
+        gliner::TokenShardWriter writer(opts.outputPath, opts.tokenizerPath);
+
+        std::string_view corpus = input.view();
+        std::string text;
+        size_t pos = 0, line = 0;
+        while (pos < corpus.size()) {
+            size_t end = corpus.find('\n', pos);
+            if (end == std::string_view::npos) {
+                end = corpus.size();
+            }
+            std::string_view raw = corpus.substr(pos, end - pos);
+            if (!raw.empty() && raw.back() == '\r') {
+                raw.remove_suffix(1);
+            }
+            pos = end + 1;
+            line++;
+            if (raw.empty()) {
+                continue;
+            }
+            if (!opts.jsonl) {
+                text.assign(raw);
+            } else {
+                std::string_view value;
+                if (!gliner::json::findField(raw, opts.field, value) || !gliner::json::parseString(value, text)) {
+                    std::cerr << "WARNING! Line " << line << ": no string field '" << opts.field << "'." << std::endl;
+                    text.clear();
+                }
+            }
+            writer.add(text);
+        }
+        writer.finish();
+        std::cerr << "Wrote " << writer.size() << " documents to " << opts.outputPath << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
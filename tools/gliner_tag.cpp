@@ -0,0 +1,268 @@
+// Bulk tagger for large local corpora.
+//
+// The input (JSONL or plain text, one record per line) is memory-mapped and split
+// into records without copying. Records are processed in windows: each window is
+// sorted by length, cut into batches and tagged by N worker sessions, then written
+// out as JSONL in input order while the next window is being tagged. Memory use is
+// bounded by the window size.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "GLiNER/gliner_config.hpp"
+#include "GLiNER/mapped_file.hpp"
+#include "GLiNER/model.hpp"
+#include "common.hpp"
+#include "json.hpp"
+
+namespace {
+    struct Options {
+        std::string modelPath;
+        std::string tokenizerPath;
+        std::string inputPath;
+        std::string outputPath = "-";
+        std::vector<std::string> labels;
+        std::string field = "text";
+        bool jsonl = true;
+        size_t batchSize = 8;
+        size_t workers = 1;
+        int threadsPerWorker = 0;
+        size_t window = 4096;
+        float threshold = 0.5;
+        bool flatNer = true;
+        bool multiLabel = false;
+        bool tokenLevel = false;
+        int maxWidth = 12;
+        int maxLength = 512;
+    };
+
+    void printUsage() {
+        std::cerr <<
+            "Usage: gliner_tag --model MODEL.onnx --tokenizer tokenizer.json --labels a,b,c --input CORPUS [options]\n"
+            "  --output PATH        output JSONL file (default: stdout)\n"
+            "  --format jsonl|text  input format (default: jsonl)\n"
+            "  --field NAME         JSON field holding the text (default: text)\n"
+            "  --batch-size N       texts per session run (default: 8)\n"
+            "  --workers N          number of sessions running in parallel (default: 1)\n"
+            "  --threads N          intra-op threads per session (default: cores / workers)\n"
+            "  --window N           records buffered per window (default: 4096)\n"
+            "  --threshold X        span probability threshold (default: 0.5)\n"
+            "  --nested             allow nested spans\n"
+            "  --multi-label        allow several labels per span\n"
+            "  --token-level        model is a token-level GLiNER\n"
+            "  --max-width N        maximum span width in words (default: 12)\n"
+            "  --max-length N       maximum sequence length in tokens (default: 512)\n";
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opts) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::runtime_error("Missing value for " + arg);
+                }
+                return argv[++i];
+            };
+            if (arg == "--model") opts.modelPath = next();
+            else if (arg == "--tokenizer") opts.tokenizerPath = next();
+            else if (arg == "--input") opts.inputPath = next();
+            else if (arg == "--output") opts.outputPath = next();
+            else if (arg == "--labels") opts.labels = gliner::tools::splitList(next());
+            else if (arg == "--format") opts.jsonl = next() != "text";
+            else if (arg == "--field") opts.field = next();
+            else if (arg == "--batch-size") opts.batchSize = std::stoul(next());
+            else if (arg == "--workers") opts.workers = std::stoul(next());
+            else if (arg == "--threads") opts.threadsPerWorker = std::stoi(next());
+            else if (arg == "--window") opts.window = std::stoul(next());
+            else if (arg == "--threshold") opts.threshold = std::stof(next());
+            else if (arg == "--nested") opts.flatNer = false;
+            else if (arg == "--multi-label") opts.multiLabel = true;
+            else if (arg == "--token-level") opts.tokenLevel = true;
+            else if (arg == "--max-width") opts.maxWidth = std::stoi(next());
+            else if (arg == "--max-length") opts.maxLength = std::stoi(next());
+            else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                return false;
+            }
+        }
+        return !opts.modelPath.empty() && !opts.tokenizerPath.empty() && !opts.inputPath.empty() && !opts.labels.empty();
+    }
+
+    struct Record {
+        size_t line;
+        std::string_view raw;
+    };
+
+    class Tagger {
+    private:
+        const Options& opts;
+        Ort::Env env;
+        Ort::SessionOptions sessionOptions;
+        std::vector<std::unique_ptr<gliner::Model>> models;
+
+    public:
+        explicit Tagger(const Options& opts) : opts(opts), env(ORT_LOGGING_LEVEL_WARNING, "gliner_tag") {
+            int threads = opts.threadsPerWorker;
+            if (threads <= 0) {
+                threads = std::max(1, int(std::thread::hardware_concurrency() / opts.workers));
+            }
+            sessionOptions.SetIntraOpNumThreads(threads);
+            sessionOptions.SetGraphOptimizationLevel(ORT_ENABLE_ALL);
+
+            gliner::Config config{opts.maxWidth, opts.maxLength, opts.tokenLevel ? gliner::TOKEN_LEVEL : gliner::SPAN_LEVEL};
+            for (size_t w = 0; w < opts.workers; w++) {
+                models.push_back(std::make_unique<gliner::Model>(
+                    opts.modelPath, opts.tokenizerPath, config, env, sessionOptions
+                ));
+            }
+        }
+
+        // Tags one window of records; the returned spans are in window order.
+        std::vector<std::vector<gliner::Span>> tag(const std::vector<Record>& records) {
+            std::vector<std::string> texts(records.size());
+            for (size_t i = 0; i < records.size(); i++) {
+                if (!opts.jsonl) {
+                    texts[i] = std::string(records[i].raw);
+                    continue;
+                }
+                std::string_view value;
+                if (!gliner::json::findField(records[i].raw, opts.field, value) ||
+                    !gliner::json::parseString(value, texts[i])) {
+                    std::cerr << "WARNING! Line " << records[i].line + 1 << ": no string field '" << opts.field << "'." << std::endl;
+                    texts[i].clear();
+                }
+            }
+
+            // Length-sorted batches keep padding inside each batch small.
+            std::vector<size_t> order;
+            order.reserve(texts.size());
+            for (size_t i = 0; i < texts.size(); i++) {
+                if (!texts[i].empty()) {
+                    order.push_back(i);
+                }
+            }
+            std::stable_sort(order.begin(), order.end(), [&texts](size_t a, size_t b) {
+                return texts[a].size() < texts[b].size();
+            });
+
+            std::vector<std::vector<gliner::Span>> results(records.size());
+            size_t numBatches = (order.size() + opts.batchSize - 1) / opts.batchSize;
+            std::atomic<size_t> nextBatch{0};
+            std::vector<std::future<void>> workers;
+            for (auto& model : models) {
+                workers.push_back(std::async(std::launch::async, [&, m = model.get()] {
+                    std::vector<std::string> batch;
+                    for (size_t b = nextBatch++; b < numBatches; b = nextBatch++) {
+                        size_t begin = b * opts.batchSize;
+                        size_t end = std::min(begin + opts.batchSize, order.size());
+                        batch.clear();
+                        for (size_t k = begin; k < end; k++) {
+                            batch.push_back(std::move(texts[order[k]]));
+                        }
+                        auto spans = m->inference(batch, opts.labels, opts.flatNer, opts.threshold, opts.multiLabel);
+                        for (size_t k = begin; k < end; k++) {
+                            results[order[k]] = std::move(spans[k - begin]);
+                        }
+                    }
+                }));
+            }
+            for (auto& worker : workers) {
+                worker.get(); // rethrows worker failures
+            }
+            return results;
+        }
+    };
+
+    void writeWindow(FILE* out, const std::vector<Record>& records, const std::vector<std::vector<gliner::Span>>& results) {
+        std::string buffer;
+        for (size_t i = 0; i < records.size(); i++) {
+            buffer += "{\"line\":";
+            buffer += std::to_string(records[i].line);
+            buffer += ",\"spans\":";
+            gliner::json::appendSpans(buffer, results[i]);
+            buffer += "}\n";
+        }
+        if (std::fwrite(buffer.data(), 1, buffer.size(), out) != buffer.size()) {
+            throw std::runtime_error("Failed to write output");
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opts;
+    try {
+        if (!parseArgs(argc, argv, opts)) {
+            printUsage();
+            return 1;
+        }
+        opts.batchSize = std::max<size_t>(1, opts.batchSize);
+        opts.workers = std::max<size_t>(1, opts.workers);
+        opts.window = std::max(opts.window, opts.batchSize);
+
+        gliner::MappedFile input(opts.inputPath);
+        Tagger tagger(opts);
+
+        FILE* out = opts.outputPath == "-" ? stdout : std::fopen(opts.outputPath.c_str(), "wb");
+        if (out == nullptr) {
+            throw std::runtime_error("Cannot open output file: " + opts.outputPath);
+        }
+
+        std::string_view corpus = input.view();
+        size_t pos = 0, line = 0;
+        std::vector<Record> window, written;
+        std::vector<std::vector<gliner::Span>> results;
+        std::future<void> pendingWrite;
+
+        while (pos < corpus.size()) {
+            window.clear();
+            while (pos < corpus.size() && window.size() < opts.window) {
+                size_t end = corpus.find('\n', pos);
+                if (end == std::string_view::npos) {
+                    end = corpus.size();
+                }
+                std::string_view raw = corpus.substr(pos, end - pos);
+                if (!raw.empty() && raw.back() == '\r') {
+                    raw.remove_suffix(1);
+                }
+                if (!raw.empty()) {
+                    window.push_back({line, raw});
+                }
+                pos = end + 1;
+                line++;
+            }
+
+            auto windowResults = tagger.tag(window);
+
+            // Write the previous window's output while the next one is tagged.
+            if (pendingWrite.valid()) {
+                pendingWrite.get();
+            }
+            written.swap(window);
+            results = std::move(windowResults);
+            pendingWrite = std::async(std::launch::async, [&] { writeWindow(out, written, results); });
+        }
+        if (pendingWrite.valid()) {
+            pendingWrite.get();
+        }
+
+        if (out != stdout) {
+            std::fclose(out);
+        } else {
+            std::fflush(out);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,261 @@
+#pragma once
+
+// Minimal JSON helpers shared by the command-line tools. Only what the tools
+// need is supported: field lookup in a flat object, strings, string arrays,
+// numbers and booleans, plus serialization of spans.
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "GLiNER/gliner_structs.hpp"
+
+namespace gliner::json {
+    inline size_t skipWhitespace(std::string_view s, size_t pos) {
+        while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\t' || s[pos] == '\n' || s[pos] == '\r')) {
+            pos++;
+        }
+        return pos;
+    }
+
+    // Returns the position just past the closing quote of the string starting at pos.
+    inline size_t scanString(std::string_view s, size_t pos) {
+        for (pos++; pos < s.size(); pos++) {
+            if (s[pos] == '\\') {
+                pos++;
+            } else if (s[pos] == '"') {
+                return pos + 1;
+            }
+        }
+        return std::string_view::npos;
+    }
+
+    // Returns the position just past the value starting at pos.
+    inline size_t scanValue(std::string_view s, size_t pos) {
+        if (pos >= s.size()) {
+            return std::string_view::npos;
+        }
+        if (s[pos] == '"') {
+            return scanString(s, pos);
+        }
+        if (s[pos] == '{' || s[pos] == '[') {
+            int depth = 0;
+            while (pos < s.size()) {
+                char c = s[pos];
+                if (c == '"') {
+                    pos = scanString(s, pos);
+                    if (pos == std::string_view::npos) {
+                        return pos;
+                    }
+                    continue;
+                }
+                if (c == '{' || c == '[') {
+                    depth++;
+                } else if (c == '}' || c == ']') {
+                    if (--depth == 0) {
+                        return pos + 1;
+                    }
+                }
+                pos++;
+            }
+            return std::string_view::npos;
+        }
+        while (pos < s.size() && s[pos] != ',' && s[pos] != '}' && s[pos] != ']' &&
+               s[pos] != ' ' && s[pos] != '\n' && s[pos] != '\r' && s[pos] != '\t') {
+            pos++;
+        }
+        return pos;
+    }
+
+    // Finds the raw value of a top-level key of an object.
+    inline bool findField(std::string_view object, std::string_view key, std::string_view& value) {
+        size_t pos = skipWhitespace(object, 0);
+        if (pos >= object.size() || object[pos] != '{') {
+            return false;
+        }
+        pos++;
+        while (true) {
+            pos = skipWhitespace(object, pos);
+            if (pos >= object.size() || object[pos] != '"') {
+                return false;
+            }
+            size_t keyEnd = scanString(object, pos);
+            if (keyEnd == std::string_view::npos) {
+                return false;
+            }
+            std::string_view currKey = object.substr(pos + 1, keyEnd - pos - 2);
+            pos = skipWhitespace(object, keyEnd);
+            if (pos >= object.size() || object[pos] != ':') {
+                return false;
+            }
+            pos = skipWhitespace(object, pos + 1);
+            size_t valueEnd = scanValue(object, pos);
+            if (valueEnd == std::string_view::npos) {
+                return false;
+            }
+            if (currKey == key) {
+                value = object.substr(pos, valueEnd - pos);
+                return true;
+            }
+            pos = skipWhitespace(object, valueEnd);
+            if (pos >= object.size() || object[pos] != ',') {
+                return false;
+            }
+            pos++;
+        }
+    }
+
+    inline void appendUtf8(std::string& out, unsigned codepoint) {
+        if (codepoint < 0x80) {
+            out.push_back(static_cast<char>(codepoint));
+        } else if (codepoint < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+            out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+        } else if (codepoint < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (codepoint >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+        }
+    }
+
+    inline bool parseString(std::string_view value, std::string& out) {
+        if (value.size() < 2 || value.front() != '"' || value.back() != '"') {
+            return false;
+        }
+        out.clear();
+        out.reserve(value.size() - 2);
+        for (size_t i = 1; i + 1 < value.size(); i++) {
+            char c = value[i];
+            if (c != '\\') {
+                out.push_back(c);
+                continue;
+            }
+            if (++i + 1 >= value.size()) {
+                return false;
+            }
+            switch (value[i]) {
+            case 'n': out.push_back('\n'); break;
+            case 't': out.push_back('\t'); break;
+            case 'r': out.push_back('\r'); break;
+            case 'b': out.push_back('\b'); break;
+            case 'f': out.push_back('\f'); break;
+            case 'u': {
+                if (i + 5 > value.size() - 1) {
+                    return false;
+                }
+                unsigned codepoint = std::strtoul(std::string(value.substr(i + 1, 4)).c_str(), nullptr, 16);
+                i += 4;
+                if (codepoint >= 0xD800 && codepoint < 0xDC00 && i + 7 <= value.size() - 1 && value[i + 1] == '\\' && value[i + 2] == 'u') {
+                    unsigned low = std::strtoul(std::string(value.substr(i + 3, 4)).c_str(), nullptr, 16);
+                    codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+                appendUtf8(out, codepoint);
+                break;
+            }
+            default: out.push_back(value[i]); break; // '"', '\\' and '/'
+            }
+        }
+        return true;
+    }
+
+    inline bool parseStringArray(std::string_view value, std::vector<std::string>& out) {
+        if (value.empty() || value.front() != '[') {
+            return false;
+        }
+        out.clear();
+        size_t pos = skipWhitespace(value, 1);
+        if (pos < value.size() && value[pos] == ']') {
+            return true;
+        }
+        while (pos < value.size()) {
+            size_t end = scanString(value, pos);
+            if (value[pos] != '"' || end == std::string_view::npos) {
+                return false;
+            }
+            out.emplace_back();
+            if (!parseString(value.substr(pos, end - pos), out.back())) {
+                return false;
+            }
+            pos = skipWhitespace(value, end);
+            if (pos < value.size() && value[pos] == ']') {
+                return true;
+            }
+            if (pos >= value.size() || value[pos] != ',') {
+                return false;
+            }
+            pos = skipWhitespace(value, pos + 1);
+        }
+        return false;
+    }
+
+    inline bool parseNumber(std::string_view value, double& out) {
+        std::string tmp(value);
+        char* end = nullptr;
+        out = std::strtod(tmp.c_str(), &end);
+        return end != tmp.c_str() && *end == '\0';
+    }
+
+    inline bool parseBool(std::string_view value, bool& out) {
+        if (value == "true") {
+            out = true;
+            return true;
+        }
+        if (value == "false") {
+            out = false;
+            return true;
+        }
+        return false;
+    }
+
+    inline void appendString(std::string& out, std::string_view s) {
+        out.push_back('"');
+        for (char c : s) {
+            switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                    out += buf;
+                } else {
+                    out.push_back(c);
+                }
+            }
+        }
+        out.push_back('"');
+    }
+
+    inline void appendSpans(std::string& out, const std::vector<Span>& spans) {
+        out.push_back('[');
+        for (size_t i = 0; i < spans.size(); i++) {
+            const Span& span = spans[i];
+            if (i > 0) {
+                out.push_back(',');
+            }
+            char buf[64];
+            out += "{\"start\":";
+            out += std::to_string(span.startIdx);
+            out += ",\"end\":";
+            out += std::to_string(span.endIdx);
+            out += ",\"text\":";
+            appendString(out, span.text);
+            out += ",\"label\":";
+            appendString(out, span.classLabel);
+            std::snprintf(buf, sizeof(buf), ",\"score\":%.6g}", span.prob);
+            out += buf;
+        }
+        out.push_back(']');
+    }
+}